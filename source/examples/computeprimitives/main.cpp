@@ -0,0 +1,436 @@
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glbinding/gl/gl.h>
+
+#include <GLFW/glfw3.h>
+
+#include <globjects/globjects.h>
+#include <globjects/logging.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/PrefixScan.h>
+#include <globjects/RadixSort.h>
+#include <globjects/StreamCompaction.h>
+
+
+using namespace gl;
+using namespace globjects;
+
+
+namespace
+{
+    // written past the requested count, to detect out of range writes
+    const GLuint s_sentinel = 0xdeadbeef;
+    const std::size_t s_padding = 16;
+
+    std::mt19937 g_generator(42);
+
+    // element counts around the tile size and the level boundaries of the hierarchical scan
+    std::vector<GLuint> testCounts()
+    {
+        const GLuint tile = PrefixScan::s_tileSize;
+
+        return {
+            0, 1, 2, 31, 32, 33,
+            tile - 1, tile, tile + 1,
+            2 * tile - 1, 2 * tile, 2 * tile + 1,
+            tile * tile - 1, tile * tile, tile * tile + 1,
+            1000000
+        };
+    }
+
+    // small integers, so float sums are exact up to 2^24 and match the reference bitwise
+    template <typename T>
+    std::vector<T> randomValues(const GLuint count)
+    {
+        std::uniform_int_distribution<int> distribution(0, 3);
+
+        std::vector<T> values(count);
+
+        for (auto & value : values)
+            value = static_cast<T>(distribution(g_generator));
+
+        return values;
+    }
+
+    template <typename T>
+    std::vector<T> referenceScan(const std::vector<T> & values, const PrefixScan::Mode mode)
+    {
+        std::vector<T> result(values.size());
+
+        T sum = T(0);
+
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            if (mode == PrefixScan::Mode::Inclusive)
+                sum += values[i];
+
+            result[i] = sum;
+
+            if (mode == PrefixScan::Mode::Exclusive)
+                sum += values[i];
+        }
+
+        return result;
+    }
+
+    std::unique_ptr<Buffer> createBuffer(const void * data, const std::size_t size)
+    {
+        std::vector<unsigned char> bytes(size + s_padding * sizeof(GLuint));
+
+        if (size > 0)
+            std::memcpy(bytes.data(), data, size);
+
+        for (std::size_t i = 0; i < s_padding; ++i)
+            std::memcpy(bytes.data() + size + i * sizeof(GLuint), &s_sentinel, sizeof(GLuint));
+
+        auto buffer = Buffer::create();
+        buffer->setData(bytes, GL_DYNAMIC_COPY);
+
+        return buffer;
+    }
+
+    bool sentinelsIntact(const Buffer * buffer, const std::size_t size)
+    {
+        const auto padding = buffer->getSubData<GLuint>(static_cast<GLsizeiptr>(s_padding), static_cast<GLintptr>(size));
+
+        for (const auto value : padding)
+        {
+            if (value != s_sentinel)
+                return false;
+        }
+
+        return true;
+    }
+
+    template <typename T>
+    bool checkScan(PrefixScan & scan, const GLuint count, const PrefixScan::Mode mode)
+    {
+        const auto values = randomValues<T>(count);
+        const auto expected = referenceScan(values, mode);
+        const std::size_t size = count * sizeof(T);
+
+        auto input = createBuffer(values.data(), size);
+        auto output = createBuffer(nullptr, size);
+
+        scan.scan(input.get(), output.get(), count, mode);
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        const auto result = output->getSubData<T>(static_cast<GLsizeiptr>(count));
+
+        for (GLuint i = 0; i < count; ++i)
+        {
+            if (result[i] != expected[i])
+            {
+                std::cout << "  mismatch at " << i << " of " << count << ": " << result[i] << " instead of " << expected[i] << std::endl;
+                return false;
+            }
+        }
+
+        if (!sentinelsIntact(output.get(), size))
+        {
+            std::cout << "  write beyond " << count << " elements" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool checkCompaction(StreamCompaction & compaction, const GLuint count)
+    {
+        std::uniform_int_distribution<GLuint> distribution(0, 1000);
+
+        std::vector<GLuint> values(count);
+        for (auto & value : values)
+            value = distribution(g_generator);
+
+        std::vector<GLuint> expected;
+        for (const auto value : values)
+        {
+            if (value % 3u == 0u)
+                expected.push_back(value);
+        }
+
+        auto input = createBuffer(values.data(), count * sizeof(GLuint));
+        auto output = createBuffer(nullptr, count * sizeof(GLuint));
+
+        compaction.compact(input.get(), output.get(), count);
+
+        const GLuint selected = compaction.readCount();
+
+        if (selected != expected.size())
+        {
+            std::cout << "  selected " << selected << " instead of " << expected.size() << " of " << count << std::endl;
+            return false;
+        }
+
+        if (output->getSubData<GLuint>(static_cast<GLsizeiptr>(selected)) != expected)
+        {
+            std::cout << "  selected elements or their order differ for " << count << " elements" << std::endl;
+            return false;
+        }
+
+        if (!sentinelsIntact(output.get(), count * sizeof(GLuint)))
+        {
+            std::cout << "  write beyond " << count << " elements" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    // keys with all 32 bits random, so bits above keyBits have to be left unsorted
+    bool checkRadixSort(RadixSort & sort, const GLuint count, const GLuint keyBits, const bool pairs)
+    {
+        const GLuint mask = keyBits >= 32 ? ~0u : (1u << keyBits) - 1u;
+
+        std::vector<GLuint> keys(count);
+        for (auto & key : keys)
+            key = static_cast<GLuint>(g_generator());
+
+        std::vector<GLuint> order(count);
+        for (GLuint i = 0; i < count; ++i)
+            order[i] = i;
+
+        std::stable_sort(order.begin(), order.end(), [&](const GLuint a, const GLuint b) {
+            return (keys[a] & mask) < (keys[b] & mask);
+        });
+
+        auto keyBuffer = createBuffer(keys.data(), count * sizeof(GLuint));
+        std::unique_ptr<Buffer> valueBuffer;
+
+        if (pairs)
+        {
+            // values are the original indices, so stability is checked as well
+            std::vector<GLuint> indices(count);
+            for (GLuint i = 0; i < count; ++i)
+                indices[i] = i;
+
+            valueBuffer = createBuffer(indices.data(), count * sizeof(GLuint));
+        }
+
+        sort.sort(keyBuffer.get(), pairs ? valueBuffer.get() : nullptr, count, keyBits);
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        const auto sortedKeys = keyBuffer->getSubData<GLuint>(static_cast<GLsizeiptr>(count));
+        const auto sortedValues = pairs ? valueBuffer->getSubData<GLuint>(static_cast<GLsizeiptr>(count)) : std::vector<GLuint>();
+
+        for (GLuint i = 0; i < count; ++i)
+        {
+            if (sortedKeys[i] != keys[order[i]] || (pairs && sortedValues[i] != order[i]))
+            {
+                std::cout << "  mismatch at " << i << " of " << count << " (" << keyBits << " key bits" << (pairs ? ", pairs" : "") << ")" << std::endl;
+                return false;
+            }
+        }
+
+        if (!sentinelsIntact(keyBuffer.get(), count * sizeof(GLuint)) || (pairs && !sentinelsIntact(valueBuffer.get(), count * sizeof(GLuint))))
+        {
+            std::cout << "  write beyond " << count << " elements" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool checkScans(const bool allowSubgroups)
+    {
+        auto unsignedScan = PrefixScan::create(PrefixScan::Type::UnsignedInt, allowSubgroups);
+        auto floatScan = PrefixScan::create(PrefixScan::Type::Float, allowSubgroups);
+
+        if (allowSubgroups && !unsignedScan->usesSubgroups())
+        {
+            std::cout << "PrefixScan (subgroups)" << std::endl << "  not supported, skipped" << std::endl;
+            return true;
+        }
+
+        std::cout << "PrefixScan (" << (allowSubgroups ? "subgroups" : "shared memory") << ")" << std::endl;
+
+        bool passed = true;
+
+        for (const auto count : testCounts())
+        {
+            for (const auto mode : { PrefixScan::Mode::Exclusive, PrefixScan::Mode::Inclusive })
+            {
+                passed &= checkScan<GLuint>(*unsignedScan, count, mode);
+                passed &= checkScan<float>(*floatScan, count, mode);
+            }
+        }
+
+        std::cout << "  " << (passed ? "passed" : "FAILED") << std::endl;
+
+        return passed;
+    }
+
+    bool checkCompactions()
+    {
+        std::cout << "StreamCompaction" << std::endl;
+
+        auto compaction = StreamCompaction::create("value % 3u == 0u");
+
+        bool passed = true;
+
+        for (const auto count : testCounts())
+            passed &= checkCompaction(*compaction, count);
+
+        std::cout << "  " << (passed ? "passed" : "FAILED") << std::endl;
+
+        return passed;
+    }
+
+    bool checkRadixSorts()
+    {
+        std::cout << "RadixSort" << std::endl;
+
+        auto sort = RadixSort::create();
+
+        bool passed = true;
+
+        for (const auto count : testCounts())
+        {
+            // odd digit counts (4, 12, 20 and 28 bits) need the extra copy pass
+            for (const auto keyBits : { 4u, 8u, 12u, 20u, 28u, 32u })
+            {
+                passed &= checkRadixSort(*sort, count, keyBits, false);
+                passed &= checkRadixSort(*sort, count, keyBits, true);
+            }
+        }
+
+        std::cout << "  " << (passed ? "passed" : "FAILED") << std::endl;
+
+        return passed;
+    }
+
+    template <typename Run>
+    double elementsPerSecond(const GLuint count, const std::size_t iterations, Run run)
+    {
+        // warm up, e.g., to allocate internal buffers
+        run();
+        glFinish();
+
+        const auto begin = std::chrono::steady_clock::now();
+
+        for (std::size_t i = 0; i < iterations; ++i)
+            run();
+
+        glFinish();
+
+        const auto end = std::chrono::steady_clock::now();
+
+        return static_cast<double>(count) * static_cast<double>(iterations) / std::chrono::duration<double>(end - begin).count();
+    }
+
+    void benchmark(const GLuint count, const std::size_t iterations)
+    {
+        const auto values = randomValues<GLuint>(count);
+
+        auto input = Buffer::create();
+        input->setData(values, GL_STATIC_DRAW);
+
+        auto output = Buffer::create();
+        output->setData(static_cast<GLsizeiptr>(count * sizeof(GLuint)), nullptr, GL_DYNAMIC_COPY);
+
+        auto scan = PrefixScan::create(PrefixScan::Type::UnsignedInt);
+        auto sharedMemoryScan = PrefixScan::create(PrefixScan::Type::UnsignedInt, false);
+        auto compaction = StreamCompaction::create("value != 0u");
+        auto sort = RadixSort::create();
+
+        std::cout << "Throughput for " << count << " elements, " << iterations << " iterations" << std::endl << std::fixed << std::setprecision(1);
+
+        if (scan->usesSubgroups())
+        {
+            std::cout << "  PrefixScan (subgroups)     " << std::setw(10) << elementsPerSecond(count, iterations, [&]() {
+                scan->scan(input.get(), output.get(), count);
+            }) * 1e-6 << " M elements/s" << std::endl;
+        }
+
+        std::cout << "  PrefixScan (shared memory) " << std::setw(10) << elementsPerSecond(count, iterations, [&]() {
+            sharedMemoryScan->scan(input.get(), output.get(), count);
+        }) * 1e-6 << " M elements/s" << std::endl;
+
+        std::cout << "  StreamCompaction           " << std::setw(10) << elementsPerSecond(count, iterations, [&]() {
+            compaction->compact(input.get(), output.get(), count);
+        }) * 1e-6 << " M elements/s" << std::endl;
+
+        std::cout << "  RadixSort (32 bit keys)    " << std::setw(10) << elementsPerSecond(count, iterations, [&]() {
+            sort->sort(input.get(), count);
+        }) * 1e-6 << " M elements/s" << std::endl;
+    }
+}
+
+
+void error(int errnum, const char * errmsg)
+{
+    globjects::critical() << errnum << ": " << errmsg << std::endl;
+}
+
+
+// Checks the GPU compute primitives against CPU references and measures their throughput.
+// Returns 1 if a check fails; e.g., run with LIBGL_ALWAYS_SOFTWARE=1 for llvmpipe.
+// usage: computeprimitives [benchmark elements] [benchmark iterations]
+int main(int argc, char * argv[])
+{
+    const auto benchmarkCount = argc > 1 ? static_cast<GLuint>(std::atoi(argv[1])) : GLuint(1 << 22);
+    const auto iterations = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : std::size_t(20);
+
+    // Initialize GLFW
+    if (!glfwInit())
+        return 1;
+
+    glfwSetErrorCallback(error);
+
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_VISIBLE, false);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, true);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    // Create a context and, if valid, make it current
+    GLFWwindow * window = glfwCreateWindow(320, 240, "globjects Compute Primitives", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        critical() << "Context creation failed. Terminate execution.";
+
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+
+    // Initialize globjects (internally initializes glbinding, and registers the current context)
+    globjects::init([](const char * name) {
+        return glfwGetProcAddress(name);
+    });
+
+    std::cout << "OpenGL Renderer: " << renderer() << std::endl << std::endl;
+
+    bool passed = true;
+
+    {
+        passed &= checkScans(false);
+        passed &= checkScans(true);
+        passed &= checkCompactions();
+        passed &= checkRadixSorts();
+
+        std::cout << std::endl;
+
+        if (benchmarkCount > 0)
+            benchmark(benchmarkCount, iterations);
+    }
+
+    // Properly shutdown GLFW
+    glfwTerminate();
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,351 @@
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glbinding/gl/gl.h>
+
+#include <GLFW/glfw3.h>
+
+#include <globjects/globjects.h>
+#include <globjects/logging.h>
+#include <globjects/base/StaticStringSource.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/DrawQueue.h>
+#include <globjects/Program.h>
+#include <globjects/Shader.h>
+#include <globjects/State.h>
+#include <globjects/Texture.h>
+#include <globjects/VertexArray.h>
+#include <globjects/VertexAttributeBinding.h>
+
+
+using namespace gl;
+using namespace globjects;
+
+
+namespace
+{
+    const std::size_t s_programCount = 16;
+    const std::size_t s_stateCount = 8;
+    const std::size_t s_textureCount = 32;
+    const std::size_t s_vertexArrayCount = 64;
+
+    const char * s_fragmentShaderSource = R"(
+#version 330 core
+
+uniform sampler2D first;
+uniform sampler2D second;
+
+layout (location = 0) out vec4 fragColor;
+
+void main()
+{
+    fragColor = texture(first, vec2(0.5)) * texture(second, vec2(0.5));
+}
+)";
+
+    std::string vertexShaderSource(const std::size_t index)
+    {
+        return R"(
+#version 330 core
+
+layout (location = 0) in vec2 a_vertex;
+
+void main()
+{
+    gl_Position = vec4(a_vertex * 0.01 + vec2()" + std::to_string(static_cast<float>(index) / s_programCount - 0.5f) + R"(, 0.0), 0.0, 1.0);
+}
+)";
+    }
+
+    struct Scene
+    {
+        std::vector<std::unique_ptr<StaticStringSource>> sources;
+        std::vector<std::unique_ptr<Shader>> shaders;
+        std::vector<std::unique_ptr<Program>> programs;
+        std::vector<std::unique_ptr<State>> states;
+        std::vector<std::unique_ptr<Texture>> textures;
+        std::vector<std::unique_ptr<Buffer>> buffers;
+        std::vector<std::unique_ptr<VertexArray>> vertexArrays;
+    };
+
+    struct Statistics
+    {
+        std::size_t programChanges;
+        std::size_t stateChanges;
+        std::size_t textureSetChanges;
+        std::size_t vertexArrayChanges;
+    };
+
+    void createScene(Scene & scene)
+    {
+        scene.sources.push_back(Shader::sourceFromString(s_fragmentShaderSource));
+        scene.shaders.push_back(Shader::create(GL_FRAGMENT_SHADER, scene.sources.back().get()));
+
+        Shader * fragmentShader = scene.shaders.back().get();
+
+        for (std::size_t i = 0; i < s_programCount; ++i)
+        {
+            scene.sources.push_back(Shader::sourceFromString(vertexShaderSource(i)));
+            scene.shaders.push_back(Shader::create(GL_VERTEX_SHADER, scene.sources.back().get()));
+
+            auto program = Program::create();
+            program->attach(scene.shaders.back().get(), fragmentShader);
+            program->setUniform("first", 0);
+            program->setUniform("second", 1);
+
+            scene.programs.push_back(std::move(program));
+        }
+
+        for (std::size_t i = 0; i < s_stateCount; ++i)
+        {
+            auto state = State::create(State::DeferredMode);
+
+            if (i & 1)
+                state->enable(GL_BLEND);
+            else
+                state->disable(GL_BLEND);
+
+            state->blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            state->depthFunc(i & 2 ? GL_LEQUAL : GL_LESS);
+
+            scene.states.push_back(std::move(state));
+        }
+
+        for (std::size_t i = 0; i < s_textureCount; ++i)
+        {
+            const std::array<unsigned char, 4 * 4 * 4> texels{};
+
+            auto texture = Texture::createDefault(GL_TEXTURE_2D);
+            texture->image2D(0, GL_RGBA8, 4, 4, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+
+            scene.textures.push_back(std::move(texture));
+        }
+
+        for (std::size_t i = 0; i < s_vertexArrayCount; ++i)
+        {
+            const std::array<std::array<float, 2>, 3> vertices{ { { { -1.f, -1.f } }, { { 1.f, -1.f } }, { { 0.f, 1.f } } } };
+
+            auto buffer = Buffer::create();
+            buffer->setData(vertices, GL_STATIC_DRAW);
+
+            auto vertexArray = VertexArray::create();
+            auto binding = vertexArray->binding(0);
+            binding->setAttribute(0);
+            binding->setBuffer(buffer.get(), 0, sizeof(std::array<float, 2>));
+            binding->setFormat(2, GL_FLOAT, GL_FALSE, 0);
+            vertexArray->enable(0);
+
+            scene.buffers.push_back(std::move(buffer));
+            scene.vertexArrays.push_back(std::move(vertexArray));
+        }
+    }
+
+    // Draws in submission order, skipping redundant bindings only; the baseline for DrawQueue (transparency is ignored)
+    Statistics executeUnsorted(const std::vector<DrawQueue::Draw> & draws, const std::vector<std::vector<const Texture *>> & textureSets)
+    {
+        Statistics statistics{ 0, 0, 0, 0 };
+
+        const Program * program = nullptr;
+        const State * state = nullptr;
+        const VertexArray * vertexArray = nullptr;
+        std::uint32_t textureSet = 0;
+
+        for (const auto & draw : draws)
+        {
+            if (draw.program != program)
+            {
+                draw.program->use();
+                program = draw.program;
+                ++statistics.programChanges;
+            }
+
+            if (draw.state != state)
+            {
+                draw.state->apply();
+                state = draw.state;
+                ++statistics.stateChanges;
+            }
+
+            if (draw.textureSet != textureSet)
+            {
+                const auto & textures = textureSets[draw.textureSet];
+
+                for (std::size_t i = 0; i < textures.size(); ++i)
+                    textures[i]->bindActive(static_cast<GLuint>(i));
+
+                textureSet = draw.textureSet;
+                ++statistics.textureSetChanges;
+            }
+
+            if (draw.vertexArray != vertexArray)
+            {
+                draw.vertexArray->bind();
+                vertexArray = draw.vertexArray;
+                ++statistics.vertexArrayChanges;
+            }
+
+            glDrawArrays(draw.mode, draw.first, draw.count);
+        }
+
+        return statistics;
+    }
+
+    void print(const char * name, const double cpu, const double frame, const Statistics & statistics)
+    {
+        std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(3)
+            << std::setw(9) << cpu << " ms cpu" << std::setw(9) << frame << " ms frame"
+            << std::setw(7) << statistics.programChanges << " programs"
+            << std::setw(7) << statistics.stateChanges << " states"
+            << std::setw(7) << statistics.textureSetChanges << " texture sets"
+            << std::setw(7) << statistics.vertexArrayChanges << " vertex arrays" << std::endl;
+    }
+}
+
+
+void error(int errnum, const char * errmsg)
+{
+    globjects::critical() << errnum << ": " << errmsg << std::endl;
+}
+
+
+// Compares issuing randomly ordered draws in submission order to issuing them
+// through a DrawQueue, which sorts them by program, state, textures and vertex array.
+// usage: drawqueuebenchmark [draws] [frames]
+int main(int argc, char * argv[])
+{
+    const auto drawCount = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : std::size_t(20000);
+    const auto frameCount = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : std::size_t(100);
+
+    // Initialize GLFW
+    if (!glfwInit())
+        return 1;
+
+    glfwSetErrorCallback(error);
+
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_VISIBLE, false);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, true);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    // Create a context and, if valid, make it current
+    GLFWwindow * window = glfwCreateWindow(320, 240, "globjects DrawQueue Benchmark", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        critical() << "Context creation failed. Terminate execution.";
+
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+
+    // Initialize globjects (internally initializes glbinding, and registers the current context)
+    globjects::init([](const char * name) {
+        return glfwGetProcAddress(name);
+    });
+
+    {
+        Scene scene;
+        createScene(scene);
+
+        auto queue = DrawQueue::create();
+
+        std::vector<std::vector<const Texture *>> textureSets(1);
+        std::vector<std::uint32_t> textureSetIds;
+
+        for (std::size_t i = 0; i < s_textureCount; ++i)
+        {
+            std::vector<const Texture *> textures{ scene.textures[i].get(), scene.textures[(i + 1) % s_textureCount].get() };
+
+            textureSetIds.push_back(queue->textureSet(textures));
+            textureSets.push_back(textures);
+        }
+
+        // fixed seed, so runs are comparable
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        std::vector<DrawQueue::Draw> draws;
+        draws.reserve(drawCount);
+
+        for (std::size_t i = 0; i < drawCount; ++i)
+        {
+            DrawQueue::Draw draw(scene.vertexArrays[generator() % s_vertexArrayCount].get(), scene.programs[generator() % s_programCount].get(), GL_TRIANGLES, 0, 3);
+            draw.state = scene.states[generator() % s_stateCount].get();
+            draw.textureSet = textureSetIds[generator() % s_textureCount];
+            draw.transparent = unit(generator) < 0.1f;
+            draw.depth = unit(generator);
+
+            draws.push_back(draw);
+        }
+
+        double unsortedCpu = 0.0;
+        double unsortedFrame = 0.0;
+        Statistics unsorted{ 0, 0, 0, 0 };
+
+        double queueCpu = 0.0;
+        double queueFrame = 0.0;
+        Statistics sorted{ 0, 0, 0, 0 };
+
+        for (std::size_t frame = 0; frame < frameCount; ++frame)
+        {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glFinish();
+
+            auto begin = std::chrono::steady_clock::now();
+
+            unsorted = executeUnsorted(draws, textureSets);
+
+            auto issued = std::chrono::steady_clock::now();
+            glFinish();
+            auto end = std::chrono::steady_clock::now();
+
+            unsortedCpu += std::chrono::duration<double, std::milli>(issued - begin).count();
+            unsortedFrame += std::chrono::duration<double, std::milli>(end - begin).count();
+
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glFinish();
+
+            begin = std::chrono::steady_clock::now();
+
+            for (const auto & draw : draws)
+                queue->submit(draw);
+
+            queue->execute();
+            queue->clear();
+
+            issued = std::chrono::steady_clock::now();
+            glFinish();
+            end = std::chrono::steady_clock::now();
+
+            queueCpu += std::chrono::duration<double, std::milli>(issued - begin).count();
+            queueFrame += std::chrono::duration<double, std::milli>(end - begin).count();
+
+            const auto & statistics = queue->statistics();
+            sorted = Statistics{ statistics.programChanges, statistics.stateChanges, statistics.textureSetChanges, statistics.vertexArrayChanges };
+        }
+
+        const auto frames = static_cast<double>(std::max<std::size_t>(frameCount, 1));
+
+        std::cout << drawCount << " draws, averaged over " << frameCount << " frames" << std::endl;
+        print("unsorted", unsortedCpu / frames, unsortedFrame / frames, unsorted);
+        print("DrawQueue", queueCpu / frames, queueFrame / frames, sorted);
+    }
+
+    // Properly shutdown GLFW
+    glfwTerminate();
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <glbinding/ContextHandle.h>
+#include <glbinding/ProcAddress.h>
+
+#include <GLFW/glfw3.h>
+
+#include <globjects/globjects.h>
+#include <globjects/logging.h>
+#include <globjects/UploadWorker.h>
+
+
+namespace
+{
+    const glbinding::ContextHandle s_mainContext = 1;
+
+    glbinding::ProcAddress getProcAddress(const char * name)
+    {
+        return glfwGetProcAddress(name);
+    }
+
+    GLFWwindow * createContext(GLFWwindow * shared)
+    {
+        return glfwCreateWindow(32, 32, "globjects Registry Benchmark", nullptr, shared);
+    }
+}
+
+
+void error(int errnum, const char * errmsg)
+{
+    globjects::critical() << errnum << ": " << errmsg << std::endl;
+}
+
+
+// Measures globjects::setContext() switches between registered contexts, sweeping
+// from 1 to the given number of threads, while another thread keeps registering
+// and deregistering contexts (by UploadWorkers). Each thread alternates between
+// two handles of its own, so every call performs an actual registry switch.
+// usage: registrybenchmark [max threads] [switches per thread]
+int main(int argc, char * argv[])
+{
+    const auto maxThreadCount = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : std::size_t(8);
+    const auto switches = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : std::size_t(1000000);
+
+    // Initialize GLFW
+    if (!glfwInit())
+        return 1;
+
+    glfwSetErrorCallback(error);
+
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_VISIBLE, false);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, true);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    // Windows have to be created on the main thread; the second one is used by the upload workers
+    GLFWwindow * mainWindow = createContext(nullptr);
+    GLFWwindow * churnWindow = mainWindow ? createContext(mainWindow) : nullptr;
+    if (churnWindow == nullptr)
+    {
+        globjects::critical() << "Context creation failed. Terminate execution.";
+
+        glfwTerminate();
+        return 1;
+    }
+
+    glfwMakeContextCurrent(mainWindow);
+
+    globjects::init(s_mainContext, getProcAddress);
+
+    // Two handles per thread, sharing the main context; the switches issue no OpenGL calls,
+    // so the handles need no OpenGL contexts of their own
+    const auto firstHandle = static_cast<glbinding::ContextHandle>(s_mainContext + 1);
+    const auto churnHandle = static_cast<glbinding::ContextHandle>(firstHandle + 2 * maxThreadCount);
+
+    for (std::size_t i = 0; i < 2 * maxThreadCount; ++i)
+    {
+        globjects::init(static_cast<glbinding::ContextHandle>(firstHandle + i), getProcAddress, s_mainContext);
+    }
+
+    globjects::setContext(s_mainContext);
+
+    // Churn: each UploadWorker registers its context on start and deregisters it on destruction
+    std::atomic<bool> done(false);
+    std::size_t registrations = 0;
+
+    std::thread churn([&]() {
+        while (!done)
+        {
+            globjects::UploadWorker worker(churnHandle, getProcAddress, s_mainContext,
+                [churnWindow]() { glfwMakeContextCurrent(churnWindow); },
+                []() { glfwMakeContextCurrent(nullptr); });
+
+            ++registrations;
+        }
+    });
+
+    for (std::size_t threadCount = 1; threadCount <= maxThreadCount; ++threadCount)
+    {
+        std::atomic<std::size_t> ready(0);
+        std::atomic<bool> start(false);
+
+        std::vector<double> nanosecondsPerSwitch(threadCount, 0.0);
+        std::vector<std::thread> threads;
+
+        for (std::size_t i = 0; i < threadCount; ++i)
+        {
+            threads.emplace_back([&, i]() {
+                const glbinding::ContextHandle handles[2] = {
+                    static_cast<glbinding::ContextHandle>(firstHandle + 2 * i),
+                    static_cast<glbinding::ContextHandle>(firstHandle + 2 * i + 1) };
+
+                globjects::setContext(handles[1]);
+
+                ++ready;
+                while (!start)
+                {
+                    std::this_thread::yield();
+                }
+
+                const auto begin = std::chrono::steady_clock::now();
+
+                for (std::size_t j = 0; j < switches; ++j)
+                {
+                    globjects::setContext(handles[j & 1]);
+                }
+
+                const auto end = std::chrono::steady_clock::now();
+
+                nanosecondsPerSwitch[i] = std::chrono::duration<double, std::nano>(end - begin).count() / static_cast<double>(switches);
+            });
+        }
+
+        while (ready < threadCount)
+        {
+            std::this_thread::yield();
+        }
+
+        start = true;
+
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+
+        double sum = 0.0;
+        for (const auto nanoseconds : nanosecondsPerSwitch)
+        {
+            sum += nanoseconds;
+        }
+
+        std::cout << std::setw(3) << threadCount << " threads: " << std::fixed << std::setprecision(1)
+            << sum / static_cast<double>(threadCount) << " ns per setContext()" << std::endl;
+    }
+
+    done = true;
+    churn.join();
+
+    std::cout << registrations << " context registrations meanwhile" << std::endl;
+
+    // Properly shutdown GLFW
+    glfwTerminate();
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+
+#pragma once
+
+
+#include <functional>
+#include <vector>
+
+#include <globjects/globjects_api.h>
+
+
+namespace globjects
+{
+
+
+/** \brief Per-context driver for asynchronous GPU operations.
+
+    Each registered context owns one AsyncPoller. Asynchronous operations
+    (Sync::signaledAsync(), Query::result(), Buffer::readAsync()) add a task
+    that checks for completion of the GPU work without blocking. poll()
+    checks every pending task exactly once, in a single pass, and should be
+    called once per frame on the context's thread (e.g., via
+    globjects::pollAsync()). Tasks resolve their AsyncResult, which in turn
+    invokes continuations or resumes awaiting coroutines.
+
+    \see AsyncResult
+ */
+class GLOBJECTS_API AsyncPoller
+{
+public:
+    /** \brief Checks for completion, returns true when done (and is removed afterwards).
+    */
+    using Task = std::function<bool()>;
+
+
+public:
+    AsyncPoller();
+    ~AsyncPoller();
+
+    static AsyncPoller & current();
+
+    void add(Task task);
+
+    /** \brief Checks all pending tasks once.
+        Tasks added while polling are checked in the next pass.
+        \return number of completed tasks
+    */
+    std::size_t poll();
+
+    std::size_t pendingCount() const;
+
+
+protected:
+    std::vector<Task> m_tasks;
+};
+
+
+} // namespace globjects
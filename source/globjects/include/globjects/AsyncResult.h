@@ -0,0 +1,95 @@
+
+#pragma once
+
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+namespace globjects
+{
+
+
+/** \brief Result of an asynchronous GPU operation that is resolved by the AsyncPoller.
+
+    An AsyncResult is a cheap, shareable handle to a value that becomes
+    available once the GPU finished the corresponding work (e.g., a Sync fence
+    got signaled, a Query result became available or a Buffer readback
+    completed). It never blocks: isReady() can be checked at any time and
+    then() registers a continuation that is invoked from within
+    AsyncPoller::poll().
+
+    AsyncResult implements the awaiter protocol, so with C++20 coroutines
+    it can be awaited directly. The awaiting coroutine is resumed from
+    within AsyncPoller::poll() on the thread of the polling context.
+
+    \code{.cpp}
+
+        Task readback(Buffer * buffer)
+        {
+            std::vector<unsigned char> data = co_await buffer->readAsync(0, size);
+            gl::GLuint64 elapsed = co_await query->result();
+            // ...
+        }
+
+        // once per frame
+        globjects::pollAsync();
+
+    \endcode
+
+    \see AsyncPoller
+ */
+template <typename T>
+class AsyncResult
+{
+public:
+    using Continuation = std::function<void(const T &)>;
+
+
+public:
+    AsyncResult();
+
+    bool isReady() const;
+
+    /** \brief Returns the value. Must only be called if isReady() returns true.
+    */
+    const T & get() const;
+
+    /** \brief Registers continuation, which is invoked with the value once it is available.
+        If the value is already available, continuation is invoked immediately.
+    */
+    void then(Continuation continuation) const;
+
+    /** \brief Makes the value available and invokes all registered continuations.
+        Called by the producer of the result, usually a task of the AsyncPoller.
+    */
+    void resolve(T value) const;
+
+    // awaiter protocol, usable with co_await when compiled as C++20
+    bool await_ready() const;
+    template <typename Handle>
+    void await_suspend(Handle handle) const;
+    const T & await_resume() const;
+
+
+protected:
+    struct State
+    {
+        State();
+
+        bool ready;
+        T value;
+        std::vector<Continuation> continuations;
+    };
+
+
+protected:
+    std::shared_ptr<State> m_state;
+};
+
+
+} // namespace globjects
+
+
+#include <globjects/AsyncResult.inl>
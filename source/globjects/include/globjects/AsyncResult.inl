@@ -0,0 +1,92 @@
+
+#pragma once
+
+
+#include <cassert>
+
+
+namespace globjects
+{
+
+
+template <typename T>
+AsyncResult<T>::State::State()
+: ready(false)
+, value()
+{
+}
+
+template <typename T>
+AsyncResult<T>::AsyncResult()
+: m_state(std::make_shared<State>())
+{
+}
+
+template <typename T>
+bool AsyncResult<T>::isReady() const
+{
+    return m_state->ready;
+}
+
+template <typename T>
+const T & AsyncResult<T>::get() const
+{
+    assert(m_state->ready);
+
+    return m_state->value;
+}
+
+template <typename T>
+void AsyncResult<T>::then(Continuation continuation) const
+{
+    if (m_state->ready)
+    {
+        continuation(m_state->value);
+
+        return;
+    }
+
+    m_state->continuations.push_back(std::move(continuation));
+}
+
+template <typename T>
+void AsyncResult<T>::resolve(T value) const
+{
+    assert(!m_state->ready);
+
+    m_state->value = std::move(value);
+    m_state->ready = true;
+
+    // keep the state alive, as a continuation may destroy the last other handle
+    const auto state = m_state;
+
+    std::vector<Continuation> continuations;
+    continuations.swap(state->continuations);
+
+    for (auto & continuation : continuations)
+    {
+        continuation(state->value);
+    }
+}
+
+template <typename T>
+bool AsyncResult<T>::await_ready() const
+{
+    return isReady();
+}
+
+template <typename T>
+template <typename Handle>
+void AsyncResult<T>::await_suspend(Handle handle) const
+{
+    then([handle](const T &) { handle.resume(); });
+}
+
+template <typename T>
+const T & AsyncResult<T>::await_resume() const
+{
+    return get();
+}
+
+
+} // namespace globjects
@@ -4,18 +4,23 @@
 
 #include <vector>
 #include <array>
+#include <memory>
 
 #include <glbinding/gl/types.h>
 
 #include <globjects/globjects_api.h>
 #include <globjects/Object.h>
 #include <globjects/base/Instantiator.h>
+#include <globjects/AsyncResult.h>
 
 
 namespace globjects
 {
 
 
+class Readback;
+
+
 /** \brief Wrapper for OpenGL buffer objects.
     
     The Buffer class encapsulates OpenGL buffer objects.
@@ -71,6 +76,11 @@ public:
     */
     static Buffer * fromId(gl::GLuint id);
 
+    /** \brief Creates count buffers with a single call to glGenBuffers/glCreateBuffers.
+        \param count number of buffers
+    */
+    static std::vector<std::unique_ptr<Buffer>> createMany(gl::GLsizei count);
+
     /** \brief Binds the buffer to target.
         \param target the target for binding
         \see https://www.opengl.org/sdk/docs/man4/xhtml/gl::glBindBuffer.xml
@@ -276,6 +286,25 @@ public:
     template <typename T, std::size_t Count>
     std::array<T, Count> getSubData(gl::GLintptr offset = 0) const;
 
+    /** \brief Reads back the contents of the buffers data store without stalling.
+        The range is copied into a staging buffer on the GPU and fenced; the
+        current context's AsyncPoller resolves the result once the copy is done.
+        \param offset offset from the beginning of the buffer in bytes
+        \param size size of memory in bytes
+    */
+    AsyncResult<std::vector<unsigned char>> readAsync(gl::GLintptr offset, gl::GLsizeiptr size) const;
+
+    /** \brief Reads back into caller-owned, possibly uninitialized storage without stalling.
+        data has to stay valid until the result is resolved.
+        \param data memory location of at least size bytes
+    */
+    AsyncResult<bool> readAsync(gl::GLintptr offset, gl::GLsizeiptr size, void * data) const;
+
+    /** \brief Reads back without stalling and without copying into client memory.
+        The result is a read-only mapping of the staging buffer.
+    */
+    AsyncResult<std::shared_ptr<const Readback>> readMappedAsync(gl::GLintptr offset, gl::GLsizeiptr size) const;
+
     /** \brief Wraps the OpenGL function gl::glInvalidateBufferData.
         \see https://www.opengl.org/sdk/docs/man/html/glInvalidateBufferData.xhtml
     */
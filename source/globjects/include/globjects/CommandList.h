@@ -0,0 +1,156 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+class Framebuffer;
+class Program;
+class State;
+class Texture;
+class VertexArray;
+
+
+/** \brief Records GL commands on any thread for later replay on the context's thread.
+
+    Recording makes no GL calls at all, so scene traversal can be spread
+    across worker threads, each recording into its own CommandList. The
+    commands are stored in a linear, block-allocated arena; reset() keeps
+    the blocks for the next frame. The thread that owns the context then
+    replays the lists in order with execute().
+
+    During replay, a bind shadow tracks the program, vertex array,
+    framebuffers and texture units bound by the replayed commands and skips
+    redundant binds. The shadow is reset by call() and after uniform
+    updates (which may bind the program), and it assumes no other code
+    changes these bindings while a replay is running.
+
+    All referenced objects have to stay alive until the replay finished.
+    Uniform values and names are copied into the arena, so recording does
+    not allocate once the blocks exist; values have to be trivially
+    copyable (scalars and glm types).
+
+    \code{.cpp}
+
+        // worker thread
+        list->useProgram(program);
+        list->setUniform(program, "transform", transform);
+        list->bindTexture(texture, 0);
+        list->drawElements(vao, gl::GL_TRIANGLES, count, gl::GL_UNSIGNED_INT);
+
+        // render thread
+        CommandList::execute({ list0, list1, list2 });
+
+    \endcode
+ */
+class GLOBJECTS_API CommandList : public Instantiator<CommandList>
+{
+public:
+    using UniformSetter = void (*)(Program * program, gl::GLint location, const char * name, const void * value);
+
+    static const std::size_t s_blockSize = 64 * 1024;
+
+
+public:
+    CommandList();
+    virtual ~CommandList();
+
+    /** \brief Discards all recorded commands, keeping the allocated memory.
+    */
+    void reset();
+
+    bool empty() const;
+    std::size_t commandCount() const;
+
+    void useProgram(Program * program);
+    void releaseProgram();
+
+    void bindVertexArray(const VertexArray * vertexArray);
+    void bindFramebuffer(const Framebuffer * framebuffer, gl::GLenum target);
+
+    void bindBuffer(const Buffer * buffer, gl::GLenum target);
+    void bindBufferBase(const Buffer * buffer, gl::GLenum target, gl::GLuint index);
+    void bindBufferRange(const Buffer * buffer, gl::GLenum target, gl::GLuint index, gl::GLintptr offset, gl::GLsizeiptr size);
+
+    void bindTexture(const Texture * texture, gl::GLuint unit);
+
+    template <typename T>
+    void setUniform(Program * program, gl::GLint location, const T & value);
+    template <typename T>
+    void setUniform(Program * program, const std::string & name, const T & value);
+
+    void applyState(State * state);
+
+    void drawArrays(const VertexArray * vertexArray, gl::GLenum mode, gl::GLint first, gl::GLsizei count, gl::GLsizei instanceCount = 1, gl::GLuint baseInstance = 0);
+    void drawElements(const VertexArray * vertexArray, gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices = nullptr, gl::GLsizei instanceCount = 1, gl::GLint baseVertex = 0, gl::GLuint baseInstance = 0);
+    void multiDrawElementsIndirect(const VertexArray * vertexArray, gl::GLenum mode, gl::GLenum type, const void * indirect, gl::GLsizei drawCount, gl::GLsizei stride = 0);
+
+    void dispatchCompute(Program * program, gl::GLuint numGroupsX, gl::GLuint numGroupsY, gl::GLuint numGroupsZ);
+    void memoryBarrier(gl::MemoryBarrierMask barriers);
+
+    /** \brief Records an arbitrary callable, invoked on the replaying thread.
+    */
+    void call(std::function<void()> function);
+
+    /** \brief Replays all recorded commands. Must be called on the thread owning the context.
+    */
+    void execute() const;
+
+    /** \brief Replays lists in order, sharing one bind shadow.
+    */
+    static void execute(const std::vector<const CommandList *> & lists);
+
+
+protected:
+    struct Block
+    {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t capacity;
+        std::size_t size;
+    };
+
+    struct Shadow;
+
+
+protected:
+    void * allocate(std::size_t size);
+
+    template <typename Command>
+    Command * record();
+
+    void recordUniform(Program * program, gl::GLint location, const std::string * name, const void * value, std::size_t size, UniformSetter setter);
+
+    void replay(Shadow & shadow) const;
+
+    template <typename T>
+    static void applyUniform(Program * program, gl::GLint location, const char * name, const void * value);
+
+
+protected:
+    std::vector<Block> m_blocks;
+    std::size_t m_currentBlock;
+    std::size_t m_commandCount;
+
+    std::vector<std::function<void()>> m_functions;
+};
+
+
+} // namespace globjects
+
+
+#include <globjects/CommandList.inl>
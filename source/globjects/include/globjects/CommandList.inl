@@ -0,0 +1,38 @@
+
+#pragma once
+
+
+#include <globjects/Program.h>
+
+
+namespace globjects
+{
+
+
+template <typename T>
+void CommandList::setUniform(Program * program, const gl::GLint location, const T & value)
+{
+    recordUniform(program, location, nullptr, &value, sizeof(T), &CommandList::applyUniform<T>);
+}
+
+template <typename T>
+void CommandList::setUniform(Program * program, const std::string & name, const T & value)
+{
+    recordUniform(program, -1, &name, &value, sizeof(T), &CommandList::applyUniform<T>);
+}
+
+template <typename T>
+void CommandList::applyUniform(Program * program, const gl::GLint location, const char * name, const void * value)
+{
+    if (name != nullptr)
+    {
+        program->setUniform(name, *static_cast<const T *>(value));
+    }
+    else
+    {
+        program->setUniform(location, *static_cast<const T *>(value));
+    }
+}
+
+
+} // namespace globjects
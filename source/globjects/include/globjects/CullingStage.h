@@ -0,0 +1,122 @@
+
+#pragma once
+
+
+#include <memory>
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+class Program;
+class Shader;
+class StaticStringSource;
+class Texture;
+class VertexArray;
+
+
+/** \brief Culls objects on the GPU and writes the surviving draws as indirect commands.
+
+    cull() runs a compute shader over an object buffer (an array of Object,
+    std430 layout) that tests each object's bounding sphere against the
+    view frustum and, optionally, a hierarchical depth buffer (Hi-Z). For
+    each visible object it writes a DrawElementsIndirectCommand built from
+    the object's index range to commands(); draw() consumes these commands
+    without any readback.
+
+    If GL 4.6 or GL_ARB_indirect_parameters is available, the commands are
+    compacted through an atomic counter in drawCount() and drawn with
+    glMultiDrawElementsIndirectCount. Otherwise each object keeps its slot,
+    culled objects get an instance count of 0 and all slots are drawn with
+    glMultiDrawElementsIndirect.
+
+    The Hi-Z texture has to hold the farthest window-space depth of each
+    texel at every mip level, typically built from the previous frame's
+    depth buffer by a MipGenerator with the Max filter. It is bound to texture unit 0 during cull()
+    and read with texel fetches, so its filter settings do not matter.
+
+    The shader storage binding points 0 to 2 are overwritten by cull().
+    Requires GL 4.3 (compute shaders and shader storage buffers).
+
+    \code{.cpp}
+
+        culling->setViewProjection(projection * view);
+        culling->cull(objects.get(), objectCount);
+        culling->draw(vao, gl::GL_TRIANGLES, gl::GL_UNSIGNED_INT);
+
+    \endcode
+ */
+class GLOBJECTS_API CullingStage : public Instantiator<CullingStage>
+{
+public:
+    /** \brief Per-object input record, matching the shader's std430 layout.
+    */
+    struct Object
+    {
+        glm::vec4 sphere; ///< world-space center (xyz) and radius (w)
+        gl::GLuint count;
+        gl::GLuint firstIndex;
+        gl::GLint baseVertex;
+        gl::GLuint baseInstance; ///< passed through, e.g., to identify the object via gl_BaseInstance
+    };
+
+    static const gl::GLuint s_groupSize = 64;
+
+
+public:
+    CullingStage();
+    virtual ~CullingStage();
+
+    void setViewProjection(const glm::mat4 & viewProjection);
+
+    /** \brief Enables the occlusion test against a Hi-Z texture; nullptr disables it.
+    */
+    void setHiZ(const Texture * hiZ);
+
+    /** \brief Culls objectCount objects from the Object array in objects.
+    */
+    void cull(const Buffer * objects, gl::GLuint objectCount);
+
+    /** \brief Draws the commands written by the last cull().
+    */
+    void draw(const VertexArray * vertexArray, gl::GLenum mode, gl::GLenum type) const;
+
+    /** \brief True if commands are compacted and counted in drawCount().
+    */
+    bool compacts() const;
+
+    Buffer * commands() const;
+    Buffer * drawCount() const;
+    Program * program() const;
+
+
+protected:
+    void reserve(gl::GLuint objectCount);
+
+
+protected:
+    std::unique_ptr<StaticStringSource> m_source;
+    std::unique_ptr<Shader> m_shader;
+    std::unique_ptr<Program> m_program;
+
+    std::unique_ptr<Buffer> m_commands;
+    std::unique_ptr<Buffer> m_drawCount;
+    gl::GLuint m_capacity;
+    gl::GLuint m_objectCount;
+
+    bool m_compact;
+    const Texture * m_hiZ;
+};
+
+
+} // namespace globjects
@@ -0,0 +1,198 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Program;
+class State;
+class Texture;
+class VertexArray;
+
+
+/** \brief Collects draws and issues them sorted to minimize program, state and binding changes.
+
+    Each submitted draw gets a 64-bit sort key. From the most to the least
+    significant bits it consists of
+
+    - the layer, so layers are issued in ascending order,
+    - a transparency flag, so transparent draws follow the opaque ones,
+    - for opaque draws: program, state, texture set and vertex array, then
+      the depth front-to-back,
+    - for transparent draws: nothing, or the depth back-to-front if enabled
+      by setTransparentDepthSorting().
+
+    Programs, states, texture sets and vertex arrays are mapped to dense ids
+    in the order they are first submitted after the last clear(), so the key
+    fields (12, 10, 12 and 11 bits) only have to cover the objects of one
+    frame; objects beyond a field's range share its largest id and are
+    sorted coarser. The keys are sorted
+    with a stable LSD radix sort, so draws with equal keys keep their
+    submission order. Thus, transparent draws of a layer are issued in
+    submission order by default, and only reordered by depth on request.
+
+    Texture sets are registered once with textureSet(); the textures of a
+    set are bound to the units 0 to n-1. Registrations persist until
+    clearTextureSets(), e.g., when textures are streamed or recreated.
+
+    \code{.cpp}
+
+        const auto material = queue->textureSet({ albedo, normals });
+
+        DrawQueue::Draw draw(vao, program, gl::GL_TRIANGLES, count, gl::GL_UNSIGNED_INT);
+        draw.state = opaqueState;
+        draw.textureSet = material;
+        draw.depth = 0.25f;
+
+        queue->submit(draw);
+        queue->execute();
+        queue->clear();
+
+    \endcode
+ */
+class GLOBJECTS_API DrawQueue : public Instantiator<DrawQueue>
+{
+public:
+    struct Draw
+    {
+        /** \brief Non-indexed draw, issued with glDrawArrays*().
+        */
+        Draw(const VertexArray * vertexArray, Program * program, gl::GLenum mode, gl::GLint first, gl::GLsizei count);
+
+        /** \brief Indexed draw, issued with glDrawElements*().
+        */
+        Draw(const VertexArray * vertexArray, Program * program, gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices = nullptr);
+
+        const VertexArray * vertexArray;
+        Program * program;
+        State * state; ///< applied before the draw, defaults to nullptr
+        std::uint32_t textureSet; ///< from textureSet(), defaults to 0 (no textures)
+
+        std::uint8_t layer; ///< defaults to 0
+        bool transparent; ///< defaults to false
+        float depth; ///< normalized to [0, 1], defaults to 0
+
+        gl::GLenum mode;
+        gl::GLenum type; ///< GL_NONE for non-indexed draws
+        gl::GLint first;
+        gl::GLsizei count;
+        const void * indices;
+        gl::GLsizei instanceCount; ///< defaults to 1
+        gl::GLint baseVertex; ///< defaults to 0
+        gl::GLuint baseInstance; ///< defaults to 0
+
+        const void * userData; ///< passed through to the draw callback, defaults to nullptr
+    };
+
+    /** \brief Called for each draw after its bindings are established, e.g., to update uniforms.
+    */
+    using DrawCallback = std::function<void(const Draw &)>;
+
+    struct Statistics
+    {
+        std::size_t draws;
+        std::size_t programChanges;
+        std::size_t stateChanges;
+        std::size_t textureSetChanges;
+        std::size_t vertexArrayChanges;
+    };
+
+
+public:
+    DrawQueue();
+    virtual ~DrawQueue();
+
+    /** \brief Registers a texture set, identical sets share one id.
+    */
+    std::uint32_t textureSet(const std::vector<const Texture *> & textures);
+
+    /** \brief Discards all texture sets except the empty set 0; requires an empty queue.
+        Ids returned by textureSet() before are invalid afterwards.
+    */
+    void clearTextureSets();
+
+    void setDrawCallback(DrawCallback callback);
+
+    /** \brief Sorts transparent draws back-to-front by depth instead of keeping their submission order.
+        Applies to draws submitted afterwards; disabled by default.
+    */
+    void setTransparentDepthSorting(bool enabled);
+    bool transparentDepthSorting() const;
+
+    void submit(const Draw & draw);
+
+    /** \brief Sorts the submitted draws; called by execute() if necessary.
+    */
+    void sort();
+
+    /** \brief Issues all submitted draws in key order.
+    */
+    void execute();
+
+    /** \brief Discards all draws and their dense ids; texture sets stay registered.
+    */
+    void clear();
+
+    std::size_t size() const;
+
+    /** \brief Counts of the last execute().
+    */
+    const Statistics & statistics() const;
+
+
+protected:
+    struct Entry
+    {
+        std::uint64_t key;
+        std::uint32_t index;
+    };
+
+
+protected:
+    template <typename T>
+    static std::uint32_t denseId(std::unordered_map<const T *, std::uint32_t> & ids, const T * object);
+
+    std::uint32_t textureSetId(std::uint32_t textureSet);
+    std::uint64_t key(const Draw & draw);
+
+    void bindTextureSet(std::uint32_t textureSet) const;
+    static void issue(const Draw & draw);
+
+
+protected:
+    std::vector<Draw> m_draws;
+    std::vector<Entry> m_entries;
+    std::vector<Entry> m_scratch;
+    bool m_sorted;
+
+    std::unordered_map<const Program *, std::uint32_t> m_programIds;
+    std::unordered_map<const State *, std::uint32_t> m_stateIds;
+    std::unordered_map<const VertexArray *, std::uint32_t> m_vertexArrayIds;
+
+    std::map<std::vector<const Texture *>, std::uint32_t> m_textureSetIds;
+    std::vector<std::vector<const Texture *>> m_textureSets;
+    std::vector<std::uint32_t> m_textureSetDenseIds; ///< per texture set, 0 until submitted after the last clear()
+    std::uint32_t m_textureSetDenseIdCount;
+
+    DrawCallback m_drawCallback;
+    bool m_transparentDepthSorting;
+    Statistics m_statistics;
+};
+
+
+} // namespace globjects
@@ -0,0 +1,157 @@
+
+#pragma once
+
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+class Framebuffer;
+class Sync;
+
+
+/** \brief Reads back framebuffer contents every frame without stalling, e.g., for video recording.
+
+    capture() reads the given rectangle of the framebuffer into the next of
+    a ring of pixel pack buffers and inserts a fence. Readbacks whose fence
+    has passed are handed, oldest first, to a worker thread that invokes
+    the callback with the mapped pixels, so the callback (e.g., encoding)
+    runs in parallel to rendering. Neither capture() nor the callback waits
+    for the GPU.
+
+    If all buffers of the ring are still in flight, the frame is dropped:
+    capture() returns false and droppedFrames() is increased. A ring of 3
+    buffers suffices as long as the callback keeps up with the frame rate.
+
+    Buffers are mapped persistently if GL_ARB_buffer_storage is available,
+    otherwise each buffer is mapped once its readback completed and
+    unmapped by a later capture(). Rows of a frame are rowSize() bytes
+    apart, which accounts for GL_PACK_ALIGNMENT at construction. The pixel
+    data is only valid during the callback.
+
+    The framebuffer's read buffer is used. capture(), finish() and the
+    destructor have to be called with the context of the framebuffer
+    current.
+
+    \code{.cpp}
+
+        auto capture = FrameCapture::create(fbo.get(), std::array<gl::GLint, 4>{ 0, 0, width, height }, gl::GL_RGBA, gl::GL_UNSIGNED_BYTE,
+            [&encoder](const FrameCapture::Frame & frame) { encoder.encode(frame.data, frame.rowSize, frame.height); });
+
+        // once per frame, after rendering into fbo
+        capture->capture();
+
+        // when done recording
+        capture->finish();
+
+    \endcode
+ */
+class GLOBJECTS_API FrameCapture : public Instantiator<FrameCapture>
+{
+public:
+    struct Frame
+    {
+        std::uint64_t index; ///< number of the capture() call, dropped frames included
+        gl::GLsizei width;
+        gl::GLsizei height;
+        std::size_t rowSize;
+        const unsigned char * data;
+    };
+
+    using Callback = std::function<void(const Frame &)>;
+
+
+public:
+    FrameCapture(Framebuffer * framebuffer, const std::array<gl::GLint, 4> & rect, gl::GLenum format, gl::GLenum type, Callback callback, std::size_t ringSize = 3);
+
+    /** \brief Delivers all pending frames, see finish(), and stops the worker thread.
+    */
+    virtual ~FrameCapture();
+
+    /** \brief Reads the framebuffer into the next buffer of the ring and delivers completed readbacks.
+        \return false if the frame was dropped, as no buffer was available
+    */
+    bool capture();
+
+    /** \brief Waits for all readbacks and callbacks, e.g., at the end of a recording.
+    */
+    void finish();
+
+    std::size_t rowSize() const;
+
+    std::uint64_t capturedFrames() const;
+    std::uint64_t droppedFrames() const;
+
+
+protected:
+    enum class State : unsigned int
+    {
+        Free,
+        Reading,    ///< readback in flight on the GPU
+        Delivering, ///< queued for or running the callback
+        Delivered   ///< callback done, to be unmapped and reused
+    };
+
+    struct Slot
+    {
+        std::unique_ptr<Buffer> buffer;
+        std::unique_ptr<Sync> fence;
+        const unsigned char * data;
+        std::uint64_t frame;
+        State state;
+    };
+
+
+protected:
+    /** \brief Recycles delivered buffers and delivers completed readbacks; waits for them if wait is set.
+    */
+    void update(bool wait);
+
+    void run();
+
+
+protected:
+    Framebuffer * m_framebuffer;
+    std::array<gl::GLint, 4> m_rect;
+    gl::GLenum m_format;
+    gl::GLenum m_type;
+    Callback m_callback;
+
+    std::size_t m_rowSize;
+    gl::GLsizeiptr m_size;
+    bool m_persistent;
+
+    std::vector<Slot> m_slots;
+    std::size_t m_next;
+    std::uint64_t m_frame;
+    std::uint64_t m_dropped;
+
+    mutable std::mutex m_mutex; ///< guards the slot states and the queue
+    std::condition_variable m_condition;
+    std::condition_variable m_delivered;
+    std::deque<std::size_t> m_queue;
+    bool m_running;
+
+    std::thread m_thread;
+};
+
+
+} // namespace globjects
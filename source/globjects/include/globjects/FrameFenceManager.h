@@ -0,0 +1,140 @@
+
+#pragma once
+
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Sync;
+
+
+/** \brief Paces the CPU to a fixed number of frames in flight.
+
+    The manager owns a ring of framesInFlight Sync fences that are renewed
+    instead of reallocated. endFrame() inserts a fence for the current frame;
+    beginFrame() blocks until the frame that last used the same ring slot has
+    completed on the GPU, so at most framesInFlight frames are queued.
+
+    Resources that are still in use by the GPU (e.g., streaming buffers,
+    queries or transient textures) can be released with defer(). The
+    callback is invoked once the frame it was registered for has completed,
+    either from within beginFrame(), collect(), wait() or isComplete().
+
+    \code{.cpp}
+
+        auto fences = FrameFenceManager::create(3);
+
+        // per frame
+        fences->beginFrame();
+        // GL calls
+        fences->defer([buffer]() { pool.release(buffer); });
+        fences->endFrame();
+
+    \endcode
+
+    \see Sync
+ */
+class GLOBJECTS_API FrameFenceManager : public Instantiator<FrameFenceManager>
+{
+public:
+    using Callback = std::function<void()>;
+
+    struct Statistics
+    {
+        std::uint64_t waitCount; ///< number of blocking waits that had to wait for the GPU
+        std::uint64_t waitTime;  ///< accumulated time spent waiting in nanoseconds, including waits that timed out
+        std::uint64_t maxWaitTime; ///< longest single wait in nanoseconds
+        std::uint64_t timeouts;  ///< number of waits that expired before the fence was signaled
+    };
+
+
+public:
+    FrameFenceManager(std::size_t framesInFlight = 3);
+    virtual ~FrameFenceManager();
+
+    std::size_t framesInFlight() const;
+
+    /** \brief Starts a new frame and waits for the oldest frame in flight if the ring is full.
+        \return index of the started frame
+    */
+    std::uint64_t beginFrame();
+
+    /** \brief Inserts the fence for the current frame.
+    */
+    void endFrame();
+
+    /** \brief Index of the frame between beginFrame() and endFrame(), or of the next frame to begin.
+    */
+    std::uint64_t currentFrame() const;
+
+    /** \brief Non-blocking check whether frame has been completed by the GPU.
+    */
+    bool isComplete(std::uint64_t frame);
+
+    /** \brief Waits until frame has been completed by the GPU or timeout (in nanoseconds) expired.
+        \return true if frame is complete
+    */
+    bool wait(std::uint64_t frame, gl::GLuint64 timeout);
+    bool wait(std::uint64_t frame);
+
+    /** \brief Waits for all frames in flight.
+    */
+    void finish();
+
+    /** \brief Invokes callback once the current frame has been completed.
+    */
+    void defer(Callback callback);
+
+    /** \brief Invokes callback once frame has been completed (immediately if it already has).
+    */
+    void defer(std::uint64_t frame, Callback callback);
+
+    /** \brief Invokes the callbacks of all completed frames without blocking.
+    */
+    void collect();
+
+    const Statistics & statistics() const;
+    void resetStatistics();
+
+
+protected:
+    struct Slot
+    {
+        std::unique_ptr<Sync> fence;
+        std::uint64_t frame;
+        bool pending;
+        std::vector<Callback> callbacks;
+    };
+
+
+protected:
+    Slot & slot(std::uint64_t frame);
+
+    bool isTracked(std::uint64_t frame) const;
+    void retire(Slot & slot);
+
+
+protected:
+    std::vector<Slot> m_slots;
+    std::uint64_t m_frame;
+    bool m_inFrame;
+
+    std::vector<Callback> m_deferred;
+
+    Statistics m_statistics;
+};
+
+
+} // namespace globjects
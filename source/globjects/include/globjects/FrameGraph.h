@@ -0,0 +1,276 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+#include <globjects/TexturePool.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+class Framebuffer;
+class FramebufferCache;
+class Texture;
+
+
+/** \brief Schedules the passes of a frame and manages their transient textures and buffers.
+
+    Each pass declares in its setup callback which resources it creates,
+    reads and writes, and how (Access). compile() then
+      - culls passes whose results are never used; passes writing imported
+        resources or flagged with setSideEffect() are always kept,
+      - orders the remaining passes by their dependencies, preferring to
+        keep passes with the same attachments adjacent to save framebuffer
+        switches, and
+      - computes the lifetime of each transient resource.
+
+    execute() runs the passes in that order. Transient resources are
+    obtained from a TexturePool (or a buffer free list) right before their
+    first use and released right after their last use, so resources with
+    non-overlapping lifetimes share the same GL objects. Before a pass,
+    glMemoryBarrier is issued for reads (or writes) of resources last
+    written through image or shader storage access, with only the bits
+    required by the new access, and glTextureBarrier if a pass samples one
+    of its own attachments. Passes with attachments get a framebuffer
+    from a FramebufferCache, which is bound unless the previous pass used
+    it already; such passes must leave the framebuffer binding unchanged.
+
+    The graph is described anew each frame: clear() removes all passes
+    and resources, while pooled objects and framebuffers are kept.
+
+    \code{.cpp}
+
+        FrameGraph::Resource gbuffer, lit;
+
+        graph->addPass("geometry", [&](FrameGraph::PassBuilder & builder) {
+            gbuffer = builder.createTexture("gbuffer", { GL_TEXTURE_2D, GL_RGBA16F, width, height });
+            builder.attach(gbuffer, GL_COLOR_ATTACHMENT0);
+            builder.attach(builder.createTexture("depth", { GL_TEXTURE_2D, GL_DEPTH_COMPONENT32F, width, height }), GL_DEPTH_ATTACHMENT);
+        }, [&](const FrameGraph::PassContext & context) { drawScene(); });
+
+        graph->addPass("lighting", [&](FrameGraph::PassBuilder & builder) {
+            builder.read(gbuffer, FrameGraph::Access::Sampled);
+            builder.write(lit = builder.createTexture("lit", { GL_TEXTURE_2D, GL_RGBA16F, width, height }), FrameGraph::Access::Image);
+        }, [&](const FrameGraph::PassContext & context) {
+            context.texture(gbuffer)->bindActive(0);
+            context.texture(lit)->bindImageTexture(0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+            lighting->dispatchCompute(width / 8, height / 8, 1);
+        });
+
+        graph->execute();
+        graph->clear();
+
+    \endcode
+
+    \see TexturePool
+    \see FramebufferCache
+ */
+class GLOBJECTS_API FrameGraph : public Instantiator<FrameGraph>
+{
+public:
+    using Resource = std::size_t;
+
+    enum class Access : unsigned int
+    {
+        Sampled,       ///< texture fetches
+        Image,         ///< image load/store, incoherent
+        ShaderStorage, ///< shader storage buffers, incoherent
+        Uniform,
+        Indirect,      ///< draw or dispatch arguments
+        Vertex,        ///< vertex or element array
+        Transfer,      ///< buffer and texture copies, updates and reads
+        Attachment     ///< framebuffer attachment, see PassBuilder::attach()
+    };
+
+    class PassBuilder;
+    class PassContext;
+
+    using Setup = std::function<void(PassBuilder &)>;
+    using Execute = std::function<void(const PassContext &)>;
+
+    struct Statistics
+    {
+        std::size_t passes;
+        std::size_t culledPasses;
+        std::size_t transientResources;
+        std::size_t framebufferSwitches;
+        std::size_t barriers;
+        std::size_t peakTransientBytes; ///< estimated peak of simultaneously allocated transient textures and buffers
+    };
+
+    class GLOBJECTS_API PassBuilder
+    {
+        friend class FrameGraph;
+
+    public:
+        Resource createTexture(const std::string & name, const TexturePool::Description & description);
+        Resource createBuffer(const std::string & name, gl::GLsizeiptr size);
+
+        void read(Resource resource, Access access);
+        void write(Resource resource, Access access);
+
+        /** \brief Renders to resource, a texture, as framebuffer attachment; counts as read and write.
+        */
+        void attach(Resource resource, gl::GLenum attachment, gl::GLint level = 0, gl::GLint layer = -1);
+
+        /** \brief Keeps the pass even if none of its results are used.
+        */
+        void setSideEffect();
+
+    protected:
+        PassBuilder(FrameGraph & graph, std::size_t pass);
+
+    protected:
+        FrameGraph & m_graph;
+        std::size_t m_pass;
+    };
+
+    class GLOBJECTS_API PassContext
+    {
+        friend class FrameGraph;
+
+    public:
+        Texture * texture(Resource resource) const;
+        Buffer * buffer(Resource resource) const;
+
+        /** \brief Framebuffer with the attachments of the pass (bound already), or nullptr.
+        */
+        Framebuffer * framebuffer() const;
+
+    protected:
+        PassContext(const FrameGraph & graph, Framebuffer * framebuffer);
+
+    protected:
+        const FrameGraph & m_graph;
+        Framebuffer * m_framebuffer;
+    };
+
+
+public:
+    FrameGraph();
+    virtual ~FrameGraph();
+
+    Resource importTexture(const std::string & name, Texture * texture);
+    Resource importBuffer(const std::string & name, Buffer * buffer);
+
+    void addPass(const std::string & name, const Setup & setup, const Execute & execute);
+
+    /** \brief Culls and orders the passes; called by execute() if needed.
+    */
+    void compile();
+    void execute();
+
+    /** \brief Removes all passes and resources, keeping pooled objects for the next frame.
+    */
+    void clear();
+
+    /** \brief Names of the passes in execution order, culled passes excluded; valid after compile().
+    */
+    std::vector<std::string> executionOrder() const;
+
+    TexturePool * texturePool() const;
+    const Statistics & statistics() const;
+
+
+protected:
+    struct ResourceNode
+    {
+        std::string name;
+        bool isTexture;
+        bool imported;
+        TexturePool::Description description;
+        gl::GLsizeiptr size;
+
+        Texture * texture;
+        Buffer * buffer;
+
+        std::size_t firstUse; ///< position in the execution order
+        std::size_t lastUse;
+
+        unsigned int pendingBarriers; ///< barrier bits not yet issued since the last incoherent write
+    };
+
+    struct PooledBuffer
+    {
+        std::unique_ptr<Buffer> buffer;
+        gl::GLsizeiptr size;
+        bool inUse;
+    };
+
+    struct Use
+    {
+        Resource resource;
+        Access access;
+        bool write;
+    };
+
+    struct AttachmentUse
+    {
+        bool operator==(const AttachmentUse & other) const;
+
+        Resource resource;
+        gl::GLenum attachment;
+        gl::GLint level;
+        gl::GLint layer;
+    };
+
+    struct PassNode
+    {
+        std::string name;
+        Execute execute;
+        std::vector<Use> uses;
+        std::vector<AttachmentUse> attachments;
+        bool sideEffect;
+        bool culled;
+    };
+
+
+protected:
+    Resource addResource(const std::string & name, bool isTexture, bool imported);
+
+    void cull();
+    void order();
+    void computeLifetimes();
+
+    void allocate(ResourceNode & resource);
+    void release(ResourceNode & resource);
+
+    unsigned int barriersFor(const PassNode & pass) const;
+    bool needsTextureBarrier(const PassNode & pass) const;
+
+    static std::size_t sizeInBytes(const ResourceNode & resource);
+
+
+protected:
+    std::vector<ResourceNode> m_resources;
+    std::vector<PassNode> m_passes;
+    std::vector<std::size_t> m_order;
+    std::vector<std::vector<Resource>> m_acquires; ///< per position in the execution order
+    std::vector<std::vector<Resource>> m_releases;
+    bool m_compiled;
+
+    std::unique_ptr<TexturePool> m_texturePool;
+    std::unique_ptr<FramebufferCache> m_framebuffers;
+    std::vector<PooledBuffer> m_buffers;
+    std::size_t m_transientBytes;
+    unsigned int m_releasedBarriers; ///< pending barriers of released resources, inherited by reused objects
+
+    bool m_textureBarrierSupported;
+
+    Statistics m_statistics;
+};
+
+
+} // namespace globjects
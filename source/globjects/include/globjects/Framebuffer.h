@@ -104,6 +104,12 @@ public:
     void clearBuffer(gl::GLenum buffer, gl::GLint drawBuffer, int value);
     void clearBuffer(gl::GLenum buffer, gl::GLint drawBuffer, float value);
 
+    /** \brief Discards the contents of attachments, e.g., transient depth buffers after rendering.
+        Requires GL 4.3 or GL_ARB_invalidate_subdata.
+    */
+    void invalidate(const std::vector<gl::GLenum> & attachments);
+    void invalidateSubData(const std::vector<gl::GLenum> & attachments, const std::array<gl::GLint, 4> & rect);
+
     static void colorMask(gl::GLboolean red, gl::GLboolean green, gl::GLboolean blue, gl::GLboolean alpha);
     static void colorMask(const glm::bvec4 & mask);
     static void colorMaski(gl::GLuint buffer, gl::GLboolean red, gl::GLboolean green, gl::GLboolean blue, gl::GLboolean alpha);
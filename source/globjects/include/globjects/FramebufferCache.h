@@ -0,0 +1,126 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Framebuffer;
+class Texture;
+
+
+/** \brief Reuses framebuffers for recurring sets of texture attachments.
+
+    get() returns the framebuffer for a set of attachments, creating it on
+    first use. A new framebuffer gets all its color attachments as draw
+    buffers and its completeness is checked once; incomplete framebuffers
+    are reported and can be queried with status(). The order of the given
+    attachments does not matter.
+
+    setDrawBuffers() skips the GL call if the framebuffer already uses the
+    requested draw buffers. Draw buffers set directly on a cached
+    framebuffer bypass this tracking.
+
+    Cached framebuffers are owned by the cache and are destroyed as soon
+    as one of their textures is destroyed, or with evict().
+
+    \code{.cpp}
+
+        auto cache = FramebufferCache::create();
+
+        Framebuffer * fbo = cache->get({
+            { gl::GL_COLOR_ATTACHMENT0, color },
+            { gl::GL_DEPTH_ATTACHMENT, depth } });
+
+        fbo->bind();
+
+    \endcode
+ */
+class GLOBJECTS_API FramebufferCache : public Instantiator<FramebufferCache>
+{
+public:
+    struct Attachment
+    {
+        Attachment();
+        Attachment(gl::GLenum attachment, Texture * texture, gl::GLint level = 0, gl::GLint layer = -1);
+
+        bool operator==(const Attachment & other) const;
+        bool operator<(const Attachment & other) const;
+
+        gl::GLenum attachment;
+        Texture * texture;
+        gl::GLint level;
+        gl::GLint layer; ///< -1 attaches all layers
+    };
+
+
+public:
+    FramebufferCache();
+    virtual ~FramebufferCache();
+
+    /** \brief Returns the framebuffer with exactly the given attachments, creating it if needed.
+    */
+    Framebuffer * get(const std::vector<Attachment> & attachments);
+
+    /** \brief Sets the draw buffers of a cached framebuffer unless they are already set.
+    */
+    void setDrawBuffers(Framebuffer * framebuffer, const std::vector<gl::GLenum> & modes);
+
+    /** \brief Completeness status of a cached framebuffer as checked on creation.
+    */
+    gl::GLenum status(const Framebuffer * framebuffer) const;
+
+    /** \brief Destroys all framebuffers referencing texture.
+    */
+    void evict(const Texture * texture);
+
+    /** \brief Destroys all cached framebuffers.
+    */
+    void clear();
+
+    std::size_t size() const;
+
+
+protected:
+    using Key = std::vector<Attachment>;
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key & key) const;
+    };
+
+    struct Entry
+    {
+        std::unique_ptr<Framebuffer> framebuffer;
+        gl::GLenum status;
+        std::vector<gl::GLenum> drawBuffers;
+    };
+
+
+protected:
+    void reference(Texture * texture);
+    void dereference(Texture * texture);
+
+    Entry & entry(const Framebuffer * framebuffer);
+
+
+protected:
+    std::unordered_map<Key, Entry, KeyHash> m_entries;
+    std::unordered_map<const Framebuffer *, Entry *> m_framebuffers;
+    std::unordered_map<Texture *, std::size_t> m_references;
+};
+
+
+} // namespace globjects
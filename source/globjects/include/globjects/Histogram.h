@@ -0,0 +1,104 @@
+
+#pragma once
+
+
+#include <memory>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+#include <globjects/AsyncResult.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+class ComputeKernel;
+class Texture;
+
+
+/** \brief Counts float values of a buffer or a texture level into equally sized bins on the GPU.
+
+    Values in [minimum, maximum) are mapped linearly to binCount bins;
+    values outside the range are clamped to the first or last bin. Each
+    work group accumulates s_tileSize values in shared memory with atomic
+    operations before adding its non-empty bins to bins(), so contention
+    on global memory stays low even for a few bins.
+
+    bins() holds binCount uints and can be bound by subsequent GPU work
+    (e.g., auto exposure) without a readback, or read with binsAsync().
+
+    The shader storage binding points 0 and 1 and texture unit 0 are
+    overwritten. Requires GL 4.3.
+
+    \code{.cpp}
+
+        auto histogram = Histogram::create(64);
+        histogram->setRange(-8.0f, 4.0f);
+        histogram->compute(logLuminance.get());
+
+        histogram->binsAsync().then([](const std::vector<gl::GLuint> & bins) { ... });
+
+    \endcode
+ */
+class GLOBJECTS_API Histogram : public Instantiator<Histogram>
+{
+public:
+    static const gl::GLuint s_tileSize = 1024;
+    static const gl::GLuint s_maxBinCount = 4096;
+
+    /** \brief Texture component that selects the Rec. 709 luminance of the rgb components.
+    */
+    static const gl::GLint s_luminance = -1;
+
+
+public:
+    /** \param binCount number of bins, at most s_maxBinCount
+    */
+    Histogram(gl::GLuint binCount);
+    virtual ~Histogram();
+
+    gl::GLuint binCount() const;
+
+    void setRange(float minimum, float maximum);
+    float minimum() const;
+    float maximum() const;
+
+    /** \brief Counts the first count floats of input.
+    */
+    void compute(const Buffer * input, gl::GLuint count);
+
+    /** \brief Counts one component (or s_luminance) of a float 2D texture level.
+    */
+    void compute(const Texture * texture, gl::GLint level = 0, gl::GLint component = s_luminance);
+
+    /** \brief Holds the binCount counts of the last compute().
+    */
+    Buffer * bins() const;
+
+    /** \brief Reads the counts back without stalling, see AsyncPoller.
+    */
+    AsyncResult<std::vector<gl::GLuint>> binsAsync() const;
+
+
+protected:
+    void prepare(const ComputeKernel & kernel, gl::GLuint count);
+
+
+protected:
+    gl::GLuint m_binCount;
+    float m_minimum;
+    float m_maximum;
+
+    std::unique_ptr<ComputeKernel> m_buffer;
+    std::unique_ptr<ComputeKernel> m_texture;
+
+    std::unique_ptr<Buffer> m_bins;
+};
+
+
+} // namespace globjects
@@ -0,0 +1,157 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+class Sync;
+class VertexArray;
+
+
+/** \brief Builds indirect draw commands directly in GPU-visible memory.
+
+    The buffer is split into a ring of regions, each holding up to capacity
+    commands. begin() advances to the next region (waiting for the fence of
+    the draws that last read it), add() appends commands, and drawArrays()
+    or drawElements() issue all commands of the current batch with a single
+    multi draw indirect call.
+
+    If GL_ARB_buffer_storage is available, the buffer is persistently and
+    coherently mapped and commands are written straight into it. Otherwise
+    they are staged in a preallocated array and uploaded with one
+    glBufferSubData per draw. Neither path allocates per command or per draw.
+
+    A batch contains either array or element commands, not both. Once a
+    batch holds capacity() commands, add() rejects further commands and
+    returns false; draw the batch and begin() a new one to continue.
+
+    \code{.cpp}
+
+        auto commands = IndirectCommandBuffer::create(1024);
+
+        commands->begin();
+        for (const auto & mesh : meshes)
+        {
+            if (!commands->addElements(mesh.count, 1, mesh.firstIndex, mesh.baseVertex))
+            {
+                commands->drawElements(vao, gl::GL_TRIANGLES, gl::GL_UNSIGNED_INT);
+                commands->begin();
+                commands->addElements(mesh.count, 1, mesh.firstIndex, mesh.baseVertex);
+            }
+        }
+        commands->drawElements(vao, gl::GL_TRIANGLES, gl::GL_UNSIGNED_INT);
+
+    \endcode
+ */
+class GLOBJECTS_API IndirectCommandBuffer : public Instantiator<IndirectCommandBuffer>
+{
+public:
+    /** \brief Layout as consumed by glMultiDrawArraysIndirect.
+    */
+    struct DrawArraysCommand
+    {
+        gl::GLuint count;
+        gl::GLuint instanceCount;
+        gl::GLuint first;
+        gl::GLuint baseInstance;
+    };
+
+    /** \brief Layout as consumed by glMultiDrawElementsIndirect.
+    */
+    struct DrawElementsCommand
+    {
+        gl::GLuint count;
+        gl::GLuint instanceCount;
+        gl::GLuint firstIndex;
+        gl::GLint baseVertex;
+        gl::GLuint baseInstance;
+    };
+
+
+public:
+    /** \brief Allocates regionCount regions of capacity commands each.
+    */
+    IndirectCommandBuffer(gl::GLsizei capacity, gl::GLsizei regionCount = 3);
+    virtual ~IndirectCommandBuffer();
+
+    /** \brief Starts a new, empty batch in the next region.
+    */
+    void begin();
+
+    /** \brief Appends a command to the current batch.
+        \return false, without appending, if the batch already holds capacity() commands
+    */
+    bool add(const DrawArraysCommand & command);
+    bool add(const DrawElementsCommand & command);
+
+    bool addArrays(gl::GLuint count, gl::GLuint instanceCount = 1, gl::GLuint first = 0, gl::GLuint baseInstance = 0);
+    bool addElements(gl::GLuint count, gl::GLuint instanceCount = 1, gl::GLuint firstIndex = 0, gl::GLint baseVertex = 0, gl::GLuint baseInstance = 0);
+
+    /** \brief Issues the current batch of array commands; may be called repeatedly.
+    */
+    void drawArrays(const VertexArray * vertexArray, gl::GLenum mode);
+
+    /** \brief Issues the current batch of element commands; may be called repeatedly.
+    */
+    void drawElements(const VertexArray * vertexArray, gl::GLenum mode, gl::GLenum type);
+
+    gl::GLsizei size() const;
+    gl::GLsizei capacity() const;
+
+    bool isPersistentlyMapped() const;
+
+    Buffer * buffer() const;
+
+
+protected:
+    enum class Kind
+    {
+        None,
+        Arrays,
+        Elements
+    };
+
+    struct Region
+    {
+        std::unique_ptr<Sync> fence; // reused across frames
+        bool pending; // fence was issued and not yet waited for
+    };
+
+
+protected:
+    void * append(Kind kind, gl::GLsizeiptr size); // nullptr if the batch is full
+    gl::GLintptr prepareDraw(Kind kind);
+    void fence();
+
+
+protected:
+    std::unique_ptr<Buffer> m_buffer;
+    gl::GLsizei m_capacity;
+    gl::GLsizeiptr m_regionSize;
+
+    unsigned char * m_mapped;
+    std::vector<unsigned char> m_staging;
+
+    std::vector<Region> m_regions;
+    std::size_t m_region;
+
+    Kind m_kind;
+    gl::GLsizei m_size;
+    gl::GLsizeiptr m_uploaded;
+};
+
+
+} // namespace globjects
@@ -0,0 +1,170 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+class Program;
+class VertexArray;
+class VertexAttributeBinding;
+
+
+/** \brief Turns repeated draws of the same mesh and program into instanced draws.
+
+    Every submission consists of a mesh, a program and a fixed-size record
+    of per-instance data (e.g., a transform). Submissions are grouped by
+    mesh and program; execute() uploads all records into one streaming
+    instance buffer and issues one instanced draw per group, using the base
+    instance to select the group's records. The number of GL calls per frame
+    therefore depends on the number of unique mesh/program pairs, not on
+    the number of submissions.
+
+    The per-instance data reaches the shaders in one of two ways:
+
+    - VertexAttributes: bindInstanceBuffer() attaches the instance buffer
+      with divisor 1 to a vertex attribute binding of each mesh's vertex
+      array; the attribute formats are set up by the caller.
+    - ShaderStorage: the instance buffer is bound as shader storage buffer
+      and shaders index it with gl_BaseInstance + gl_InstanceID (GLSL 4.60
+      or GL_ARB_shader_draw_parameters).
+
+    Meshes are identified by address and have to outlive the batcher's use.
+    Groups that receive no submission between two clear() calls are
+    dropped, so meshes and programs that are no longer drawn (or destroyed)
+    are not kept.
+
+    \code{.cpp}
+
+        auto batcher = InstanceBatcher::create(sizeof(glm::mat4));
+        batcher->bindInstanceBuffer(vao->binding(4));
+
+        for (const auto & object : objects)
+            batcher->submit(&object.mesh, program, object.transform);
+
+        batcher->execute();
+        batcher->clear();
+
+    \endcode
+ */
+class GLOBJECTS_API InstanceBatcher : public Instantiator<InstanceBatcher>
+{
+public:
+    enum class Mode
+    {
+        VertexAttributes,
+        ShaderStorage
+    };
+
+    struct Mesh
+    {
+        /** \brief Non-indexed mesh.
+        */
+        Mesh(const VertexArray * vertexArray, gl::GLenum mode, gl::GLint first, gl::GLsizei count);
+
+        /** \brief Indexed mesh.
+        */
+        Mesh(const VertexArray * vertexArray, gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices = nullptr, gl::GLint baseVertex = 0);
+
+        const VertexArray * vertexArray;
+        gl::GLenum mode;
+        gl::GLenum type; ///< GL_NONE for non-indexed meshes
+        gl::GLint first;
+        gl::GLsizei count;
+        const void * indices;
+        gl::GLint baseVertex;
+    };
+
+    /** \brief Called once per group before its draw, e.g., to set shared uniforms.
+    */
+    using GroupCallback = std::function<void(const Mesh &, Program *)>;
+
+
+public:
+    /** \brief Creates a batcher for per-instance records of instanceSize bytes.
+        \param storageIndex shader storage binding index used in ShaderStorage mode
+    */
+    InstanceBatcher(gl::GLsizei instanceSize, Mode mode = Mode::VertexAttributes, gl::GLuint storageIndex = 0);
+    virtual ~InstanceBatcher();
+
+    /** \brief Attaches the instance buffer to binding and sets its divisor to 1.
+    */
+    void bindInstanceBuffer(VertexAttributeBinding * binding) const;
+
+    void setGroupCallback(GroupCallback callback);
+
+    /** \brief Adds one instance; size has to match the batcher's instance size.
+    */
+    void submit(const Mesh * mesh, Program * program, gl::GLsizei size, const void * instanceData);
+
+    template <typename T>
+    void submit(const Mesh * mesh, Program * program, const T & instanceData);
+
+    /** \brief Uploads all instance records and issues one draw per mesh/program pair.
+    */
+    void execute();
+
+    /** \brief Discards all submissions, keeping the groups submitted to, and their memory, for the next frame.
+        Groups without submissions since the previous clear() are dropped.
+    */
+    void clear();
+
+    std::size_t instanceCount() const;
+    std::size_t groupCount() const;
+
+    Buffer * instanceBuffer() const;
+
+
+protected:
+    struct Group
+    {
+        const Mesh * mesh;
+        Program * program;
+        std::vector<unsigned char> data;
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const std::pair<const Mesh *, const Program *> & key) const;
+    };
+
+
+protected:
+    void draw(const Group & group, gl::GLuint baseInstance) const;
+
+
+protected:
+    gl::GLsizei m_instanceSize;
+    Mode m_mode;
+    gl::GLuint m_storageIndex;
+
+    std::unique_ptr<Buffer> m_buffer;
+    gl::GLsizeiptr m_capacity;
+
+    std::vector<Group> m_groups;
+    std::unordered_map<std::pair<const Mesh *, const Program *>, std::size_t, KeyHash> m_groupIndices;
+    std::size_t m_instanceCount;
+
+    GroupCallback m_groupCallback;
+};
+
+
+} // namespace globjects
+
+
+#include <globjects/InstanceBatcher.inl>
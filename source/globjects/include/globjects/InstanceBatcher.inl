@@ -0,0 +1,16 @@
+
+#pragma once
+
+
+namespace globjects
+{
+
+
+template <typename T>
+void InstanceBatcher::submit(const Mesh * mesh, Program * program, const T & instanceData)
+{
+    submit(mesh, program, static_cast<gl::GLsizei>(sizeof(T)), &instanceData);
+}
+
+
+} // namespace globjects
@@ -0,0 +1,99 @@
+
+#pragma once
+
+
+#include <memory>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class ComputeKernel;
+class Texture;
+
+
+/** \brief Builds the mip levels of a 2D texture with a compute shader.
+
+    Unlike Texture::generateMipmap, the levels can be reduced with min or
+    max filters, e.g., for a hierarchical depth buffer (Hi-Z) as used by
+    CullingStage. Each dispatch samples one level and writes up to
+    s_levelsPerDispatch levels through bindImageTexture, reducing 16x16
+    texel tiles further in shared memory. A level is only chained within a
+    dispatch if its source level has even dimensions; for odd sizes, the
+    footprints widen to three texels so that no texel is dropped.
+
+    The texture needs a float format that supports image stores. For
+    GL_SRGB8_ALPHA8 textures, filtering is done in linear space and the
+    results are encoded explicitly and written through a GL_RGBA8 texture
+    view; these textures need immutable storage, e.g., from storage2D(). SRGBAverage additionally decodes
+    linear-format textures, e.g., GL_RGBA8 storing sRGB data.
+
+    Texture unit 0 and image units 0 to 4 are overwritten. Requires GL 4.3.
+
+    \code{.cpp}
+
+        auto hiZ = Texture::createDefault(GL_TEXTURE_2D);
+        hiZ->storage2D(levels, GL_R32F, viewport / 2);
+
+        auto pyramid = MipGenerator::create(MipGenerator::Filter::Max);
+        pyramid->generate(depth.get(), hiZ.get());
+
+        culling->setHiZ(hiZ.get());
+
+    \endcode
+ */
+class GLOBJECTS_API MipGenerator : public Instantiator<MipGenerator>
+{
+public:
+    enum class Filter : unsigned int
+    {
+        Average,
+        Min,
+        Max,
+        SRGBAverage
+    };
+
+    static const gl::GLint s_levelsPerDispatch = 5;
+
+
+public:
+    MipGenerator(Filter filter = Filter::Average);
+    virtual ~MipGenerator();
+
+    Filter filter() const;
+
+    /** \brief Generates all levels of texture beyond level 0.
+        The level count is taken from immutable storage, if any, or else the full chain.
+    */
+    void generate(Texture * texture);
+
+    /** \brief Generates the levelCount levels following baseLevel from baseLevel.
+    */
+    void generate(Texture * texture, gl::GLint baseLevel, gl::GLint levelCount);
+
+    /** \brief Reduces level 0 of source into level 0 of target, then generates the remaining levels of target.
+        Target level 0 should be half the size of source, e.g., a Hi-Z pyramid of a depth texture.
+    */
+    void generate(const Texture * source, Texture * target);
+
+
+protected:
+    void run(const Texture * source, gl::GLint sourceLevel, Texture * target, gl::GLint firstLevel, gl::GLint lastLevel);
+
+    static gl::GLint levelCount(const Texture * texture);
+
+
+protected:
+    Filter m_filter;
+
+    std::unique_ptr<ComputeKernel> m_kernel;
+};
+
+
+} // namespace globjects
@@ -27,6 +27,7 @@ class IDResource;
 class GLOBJECTS_API Object
 {
     friend class AbstractObjectNameImplementation;
+    friend class ObjectRegistry;
 
 
 public:
@@ -64,6 +65,8 @@ protected:
     std::unique_ptr<IDResource> m_resource;
 
     mutable void * m_objectLabelState;
+
+    std::size_t m_registryIndex; ///< position within the ObjectRegistry, for constant time deregistration
 };
 
 
@@ -0,0 +1,94 @@
+
+#pragma once
+
+
+#include <memory>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+class ComputeKernel;
+
+
+/** \brief Computes exclusive or inclusive prefix sums of uint or float buffers on the GPU.
+
+    The scan is work-efficient and hierarchical: each work group scans a
+    tile of s_tileSize elements in shared memory and writes the tile's total
+    to a block sum buffer. If there is more than one tile, the block sums
+    are scanned recursively and added back to their tiles. Buffers of any
+    length are supported; the block sum buffers are kept between calls.
+
+    If GL_KHR_shader_subgroup arithmetic is available in compute shaders,
+    the tiles are scanned with subgroup operations instead of the shared
+    memory up- and down-sweep.
+
+    input and output may be the same buffer. The shader storage binding
+    points 0 to 2 are overwritten. Requires GL 4.3.
+
+    \code{.cpp}
+
+        auto scan = PrefixScan::create(PrefixScan::Type::UnsignedInt);
+        scan->scan(counts.get(), offsets.get(), elementCount);
+
+    \endcode
+ */
+class GLOBJECTS_API PrefixScan : public Instantiator<PrefixScan>
+{
+public:
+    enum class Type
+    {
+        UnsignedInt,
+        Float
+    };
+
+    enum class Mode
+    {
+        Exclusive,
+        Inclusive
+    };
+
+    static const gl::GLuint s_tileSize = 512;
+
+
+public:
+    /** \brief Compiles the scan kernels for type, using subgroup operations if allowed and available.
+    */
+    PrefixScan(Type type = Type::UnsignedInt, bool allowSubgroups = true);
+    virtual ~PrefixScan();
+
+    /** \brief Scans count elements from input into output; both start at offset 0.
+    */
+    void scan(const Buffer * input, Buffer * output, gl::GLuint count, Mode mode = Mode::Exclusive);
+
+    Type type() const;
+    bool usesSubgroups() const;
+
+
+protected:
+    void scanLevel(const Buffer * input, Buffer * output, gl::GLuint count, bool inclusive, std::size_t level);
+
+    Buffer * blockSums(std::size_t level, gl::GLuint count);
+
+
+protected:
+    Type m_type;
+    bool m_subgroups;
+
+    std::unique_ptr<ComputeKernel> m_scanTiles;
+    std::unique_ptr<ComputeKernel> m_addBlockSums;
+
+    std::vector<std::unique_ptr<Buffer>> m_blockSums;
+    std::vector<gl::GLuint> m_blockSumCapacities;
+};
+
+
+} // namespace globjects
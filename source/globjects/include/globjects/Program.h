@@ -197,6 +197,9 @@ public:
 
     void dispatchCompute(gl::GLuint numGroupsX, gl::GLuint numGroupsY, gl::GLuint numGroupsZ);
     void dispatchCompute(const glm::uvec3 & numGroups);
+    /** \brief Reads the group counts from the buffer bound to GL_DISPATCH_INDIRECT_BUFFER at offset.
+    */
+    void dispatchComputeIndirect(gl::GLintptr offset = 0);
     void dispatchComputeGroupSize(gl::GLuint numGroupsX, gl::GLuint numGroupsY, gl::GLuint numGroupsZ, gl::GLuint groupSizeX, gl::GLuint groupSizeY, gl::GLuint groupSizeZ);
     void dispatchComputeGroupSize(const glm::uvec3 & numGroups, const glm::uvec3 & groupSizes);
 
@@ -9,12 +9,16 @@
 #include <globjects/globjects_api.h>
 #include <globjects/Object.h>
 #include <globjects/base/Instantiator.h>
+#include <globjects/AsyncResult.h>
 
 
 namespace globjects
 {
 
 
+class Buffer;
+
+
 /** \brief Encapsulates a GL Query object
     
     A Query object is used to query different aspects of the rendering 
@@ -61,11 +65,21 @@ namespace globjects
 
     \endcode
     
+    To avoid blocking on results at all, the result can be written into a 
+    Buffer using getToBuffer()/getToBuffer64() (requires 
+    ARB_query_buffer_object), retrieved asynchronously through a QueryPool or
+    awaited using result().
+    
     \see http://www.opengl.org/wiki/Query_Object
     \see http://www.opengl.org/registry/specs/ARB/timer_query.txt
+    \see http://www.opengl.org/registry/specs/ARB/query_buffer_object.txt
+    \see QueryPool
  */
 class GLOBJECTS_API Query : public Object, public Instantiator<Query>
 {
+    friend class QueryPool;
+
+
 public:
     Query();
 
@@ -104,6 +118,19 @@ public:
 
     gl::GLuint waitAndGet(gl::GLenum pname, const std::chrono::duration<int, std::nano> & timeout) const;
     gl::GLuint64 waitAndGet64(gl::GLenum pname, const std::chrono::duration<int, std::nano> & timeout) const;
+
+    /** \brief Writes the result into buffer at offset instead of client memory.
+        Using GL_QUERY_RESULT_NO_WAIT as pname the call never stalls.
+        \see http://www.opengl.org/registry/specs/ARB/query_buffer_object.txt
+    */
+    void getToBuffer(gl::GLenum pname, Buffer * buffer, gl::GLintptr offset = 0) const;
+    void getToBuffer64(gl::GLenum pname, Buffer * buffer, gl::GLintptr offset = 0) const;
+
+    /** \brief Resolves to the result once available, checked by the current context's AsyncPoller.
+        The Query object has to outlive the pending result.
+    */
+    AsyncResult<gl::GLuint64> result(gl::GLenum pname) const;
+    AsyncResult<gl::GLuint64> result() const;
     
     void counter() const;
 
@@ -0,0 +1,122 @@
+
+#pragma once
+
+
+#include <future>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Query;
+
+
+/** \brief Recycles Query objects and retrieves their results without blocking.
+
+    Query::create() allocates a new GL query name (and registers a new
+    wrapper) each time. A QueryPool instead hands out Query objects with
+    obtain() and takes them back with recycle(). As a query object's type is
+    fixed by its first use, the pool keeps separate free lists per target.
+    reserve() allocates several names with a single glGenQueries call.
+
+    Results are requested with resultAsync(), which either invokes a
+    callback or fulfills a std::future. The pool never waits for the GPU:
+    poll() checks all pending queries once for availability and should be
+    called once per frame. Queries that got their result are recycled
+    automatically.
+
+    \code{.cpp}
+
+        auto pool = QueryPool::create();
+
+        Query * query = pool->obtain(gl::GL_TIME_ELAPSED);
+        query->begin(gl::GL_TIME_ELAPSED);
+        // GL calls
+        query->end(gl::GL_TIME_ELAPSED);
+
+        pool->resultAsync(query, [](gl::GLuint64 elapsed) { ... });
+
+        // once per frame
+        pool->poll();
+
+    \endcode
+
+    \see Query
+ */
+class GLOBJECTS_API QueryPool : public Instantiator<QueryPool>
+{
+public:
+    using Callback = std::function<void(gl::GLuint64)>;
+
+
+public:
+    QueryPool();
+    virtual ~QueryPool();
+
+    /** \brief Generates count query names for target with a single GL call.
+    */
+    void reserve(gl::GLenum target, gl::GLsizei count);
+
+    /** \brief Returns an unused query for target, recycling previously used ones.
+        The query is owned by the pool.
+    */
+    Query * obtain(gl::GLenum target);
+
+    /** \brief Returns query to the pool. Pending results of query are discarded.
+    */
+    void recycle(Query * query);
+
+    /** \brief Requests the result of query (pname defaults to GL_QUERY_RESULT).
+        callback is invoked from within poll() once the result is available.
+        If recycleAfter is set, the query is recycled afterwards.
+    */
+    void resultAsync(Query * query, Callback callback, bool recycleAfter = true);
+    void resultAsync(Query * query, gl::GLenum pname, Callback callback, bool recycleAfter = true);
+
+    std::future<gl::GLuint64> resultAsync(Query * query, bool recycleAfter = true);
+    std::future<gl::GLuint64> resultAsync(Query * query, gl::GLenum pname, bool recycleAfter = true);
+
+    /** \brief Checks all pending queries once and delivers available results.
+        \return number of delivered results
+    */
+    std::size_t poll();
+
+    std::size_t pendingCount() const;
+    std::size_t inUseCount() const;
+    std::size_t availableCount(gl::GLenum target) const;
+
+
+protected:
+    struct Entry
+    {
+        std::unique_ptr<Query> query;
+        gl::GLenum target;
+    };
+
+    struct Request
+    {
+        Query * query;
+        gl::GLenum pname;
+        Callback callback;
+        bool recycleAfter;
+    };
+
+
+protected:
+    std::unordered_map<gl::GLenum, std::vector<std::unique_ptr<Query>>> m_available;
+    std::unordered_map<const Query *, Entry> m_inUse;
+    std::vector<Request> m_pending;
+};
+
+
+} // namespace globjects
@@ -0,0 +1,101 @@
+
+#pragma once
+
+
+#include <memory>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+class ComputeKernel;
+class PrefixScan;
+
+
+/** \brief Sorts 32-bit unsigned keys, optionally with 32-bit payloads, on the GPU.
+
+    Each pass handles s_bitsPerPass bits of the key, least significant
+    first: a histogram kernel counts the digits of each tile of s_tileSize
+    keys, a PrefixScan of the digit-major histograms yields every tile's
+    output offset per digit, and a scatter kernel writes keys (and values)
+    to their stable positions. The number of passes is rounded up to an
+    even number, so the sorted result ends up in the given buffers; the
+    extra pass only copies, leaving bits above keyBits unsorted. The
+    ping-pong buffers are kept between calls.
+
+    sortIndirect() reads the element count from a buffer written on the
+    GPU (e.g., by StreamCompaction) and sizes its dispatches with
+    glDispatchComputeIndirect, avoiding a readback.
+
+    Floats can be sorted by mapping them to order-preserving keys, i.e.,
+    flipping all bits of negative values and only the sign bit otherwise.
+
+    The shader storage binding points 0 to 5 are overwritten. Requires
+    GL 4.3.
+
+    \code{.cpp}
+
+        auto sort = RadixSort::create();
+        sort->sort(depthKeys.get(), particleIndices.get(), particleCount);
+
+    \endcode
+ */
+class GLOBJECTS_API RadixSort : public Instantiator<RadixSort>
+{
+public:
+    static const gl::GLuint s_bitsPerPass = 4;
+    static const gl::GLuint s_tileSize = 1024;
+
+
+public:
+    RadixSort();
+    virtual ~RadixSort();
+
+    /** \brief Sorts the first count keys; only the lowest keyBits bits are considered.
+    */
+    void sort(Buffer * keys, gl::GLuint count, gl::GLuint keyBits = 32);
+
+    /** \brief Sorts the first count keys and reorders values alongside.
+    */
+    void sort(Buffer * keys, Buffer * values, gl::GLuint count, gl::GLuint keyBits = 32);
+
+    /** \brief Sorts a GPU-determined number of keys (and values, unless nullptr).
+        \param countBuffer buffer holding the element count as uint at countOffset
+        \param maxCount upper bound of the count, larger counts are clamped
+    */
+    void sortIndirect(Buffer * keys, Buffer * values, const Buffer * countBuffer, gl::GLintptr countOffset, gl::GLuint maxCount, gl::GLuint keyBits = 32);
+
+
+protected:
+    void run(Buffer * keys, Buffer * values, gl::GLuint maxCount, bool indirect, gl::GLuint keyBits);
+    void dispatch(const ComputeKernel & kernel, gl::GLuint groups, bool indirect) const;
+
+    void reserve(gl::GLuint count, bool values);
+
+
+protected:
+    std::unique_ptr<ComputeKernel> m_setup;
+    std::unique_ptr<ComputeKernel> m_histogram;
+    std::unique_ptr<ComputeKernel> m_scatterKeys;
+    std::unique_ptr<ComputeKernel> m_scatterPairs;
+    std::unique_ptr<PrefixScan> m_scan;
+
+    std::unique_ptr<Buffer> m_state; ///< element count and indirect dispatch arguments
+    std::unique_ptr<Buffer> m_histograms;
+    std::unique_ptr<Buffer> m_offsets;
+    std::unique_ptr<Buffer> m_keys;
+    std::unique_ptr<Buffer> m_values;
+
+    gl::GLuint m_capacity;
+    gl::GLuint m_valueCapacity;
+};
+
+
+} // namespace globjects
@@ -0,0 +1,80 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/AsyncResult.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+
+
+/** \brief Read-only mapping of a staging buffer that received GPU data, e.g., by Buffer::readMappedAsync().
+
+    The data can be read in place, without copying it into client memory
+    first. The staging buffer is unmapped and released when the last
+    reference to the Readback is destroyed, which has to happen with the
+    context of the staging buffer current (e.g., within the continuation
+    invoked by pollAsync()).
+
+    \code{.cpp}
+
+        buffer->readMappedAsync(0, size).then([](const std::shared_ptr<const Readback> & readback) {
+            consume(readback->data(), readback->size());
+        });
+
+    \endcode
+
+    \see Buffer::readMappedAsync
+    \see Texture::readMappedAsync
+ */
+class GLOBJECTS_API Readback
+{
+public:
+    using Result = AsyncResult<std::shared_ptr<const Readback>>;
+
+
+public:
+    /** \brief Maps size bytes of staging for reading; the GPU has to be done writing them.
+    */
+    Readback(std::shared_ptr<Buffer> staging, gl::GLsizeiptr size);
+    ~Readback();
+
+    Readback(const Readback &) = delete;
+    Readback & operator=(const Readback &) = delete;
+
+    const unsigned char * data() const;
+    std::size_t size() const;
+
+    /** \brief Fences the commands writing into staging and resolves with its mapping once the fence has passed.
+    */
+    static Result fenced(std::shared_ptr<Buffer> staging, gl::GLsizeiptr size);
+
+    /** \brief Resolves with a copy of the data, which is unmapped right after.
+    */
+    static AsyncResult<std::vector<unsigned char>> toVector(const Result & readback);
+
+    /** \brief Copies the data into caller-owned storage, which has to stay valid until the result is resolved.
+        Resolves with false if no data could be mapped.
+    */
+    static AsyncResult<bool> copyTo(const Result & readback, void * data);
+
+
+protected:
+    std::shared_ptr<Buffer> m_staging;
+    gl::GLsizeiptr m_size;
+    const unsigned char * m_data;
+};
+
+
+} // namespace globjects
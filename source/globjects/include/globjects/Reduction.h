@@ -0,0 +1,137 @@
+
+#pragma once
+
+
+#include <memory>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+#include <globjects/AsyncResult.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+class ComputeKernel;
+class Texture;
+
+
+/** \brief Reduces a buffer or a texture level to a single value on the GPU.
+
+    Each pass reduces tiles of s_tileSize elements to one partial result
+    per work group; passes repeat over the partials until one remains,
+    which is written to result(). The result buffer holds the value
+    (4 bytes, of the reduction's Type) followed by the index of the
+    selected element as uint, so it can be bound as shader storage or
+    uniform buffer by subsequent GPU work without a readback.
+
+    For Min and Max the index refers to the first occurrence; ArgMin and
+    ArgMax only differ in intent. For Sum the index is 0. Texture texels
+    are indexed row-major, i.e., y * width + x.
+
+    The shader storage binding points 0 and 1 and texture unit 0 are
+    overwritten. Requires GL 4.3.
+
+    \code{.cpp}
+
+        auto maxDepth = Reduction::create(Reduction::Operation::Max);
+        maxDepth->reduce(depthTexture.get());
+
+        maxDepth->resultAsync().then([](const Reduction::Result & result) {
+            farPlane = result.value<float>();
+        });
+
+    \endcode
+ */
+class GLOBJECTS_API Reduction : public Instantiator<Reduction>
+{
+public:
+    enum class Operation : unsigned int
+    {
+        Sum,
+        Min,
+        Max,
+        ArgMin,
+        ArgMax
+    };
+
+    enum class Type : unsigned int
+    {
+        UnsignedInt,
+        Int,
+        Float
+    };
+
+    struct Result
+    {
+        Result();
+
+        template <typename T>
+        T value() const;
+
+        gl::GLuint bits;  ///< value as stored on the GPU
+        gl::GLuint index;
+    };
+
+    static const gl::GLuint s_tileSize = 512;
+
+    /** \brief Texture component that selects the Rec. 709 luminance of the rgb components.
+    */
+    static const gl::GLint s_luminance = -1;
+
+
+public:
+    Reduction(Operation operation, Type type = Type::Float);
+    virtual ~Reduction();
+
+    Operation operation() const;
+    Type type() const;
+
+    /** \brief Reduces the first count elements of input.
+    */
+    void reduce(const Buffer * input, gl::GLuint count);
+
+    /** \brief Reduces one component (or s_luminance) of a 2D texture level.
+        The texture's sampler type has to match the reduction's Type.
+    */
+    void reduce(const Texture * texture, gl::GLint level = 0, gl::GLint component = 0);
+
+    /** \brief Holds the Result of the last reduction.
+    */
+    Buffer * result() const;
+
+    /** \brief Reads the result back without stalling, see AsyncPoller.
+    */
+    AsyncResult<Result> resultAsync() const;
+
+
+protected:
+    void reducePartials(gl::GLuint count);
+
+    Buffer * target(gl::GLuint groups) const;
+    void reserve(gl::GLuint groups);
+
+
+protected:
+    Operation m_operation;
+    Type m_type;
+
+    std::unique_ptr<ComputeKernel> m_buffer;
+    std::unique_ptr<ComputeKernel> m_texture;
+    std::unique_ptr<ComputeKernel> m_partials;
+
+    std::unique_ptr<Buffer> m_partialsA;
+    std::unique_ptr<Buffer> m_partialsB;
+    std::unique_ptr<Buffer> m_result;
+    gl::GLuint m_capacity;
+};
+
+
+} // namespace globjects
+
+
+#include <globjects/Reduction.inl>
@@ -0,0 +1,24 @@
+
+#pragma once
+
+
+#include <cstring>
+
+
+namespace globjects
+{
+
+
+template <typename T>
+T Reduction::Result::value() const
+{
+    static_assert(sizeof(T) == sizeof(gl::GLuint), "results are 32 bit values");
+
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+
+    return value;
+}
+
+
+} // namespace globjects
@@ -0,0 +1,161 @@
+
+#pragma once
+
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <glbinding/ContextHandle.h>
+#include <glbinding/ProcAddress.h>
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Framebuffer;
+
+
+/** \brief Renders independent offscreen jobs in parallel on several contexts.
+
+    The scheduler owns one worker thread per given context. Each worker
+    makes its context current (through the windowing-system specific
+    makeCurrent callback), registers it with globjects (optionally sharing
+    objects with sharedContextId) and processes jobs until the scheduler is
+    destroyed.
+
+    A job consists of a render closure, the size and formats of the target
+    Framebuffer and a readback specification. Framebuffers are not shared
+    between contexts, so each worker maintains its own target and passes it
+    to the closure bound and cleared. After rendering, the requested pixels
+    are read back and returned through the job's future.
+
+    Jobs are distributed round-robin to per-worker queues; idle workers
+    steal from the back of other workers' queues, so uneven job costs do not
+    leave workers idle.
+
+    \code{.cpp}
+
+        std::vector<RenderJobScheduler::WorkerContext> contexts;
+        // one hidden window/pbuffer per worker
+        auto scheduler = RenderJobScheduler::create(contexts, getProcAddress);
+
+        RenderJobScheduler::Job job(256, 256, [](Framebuffer * fbo) {
+            // GL calls
+        });
+
+        std::future<std::vector<unsigned char>> pixels = scheduler->submit(std::move(job));
+
+    \endcode
+ */
+class GLOBJECTS_API RenderJobScheduler : public Instantiator<RenderJobScheduler>
+{
+public:
+    using ContextCallback = std::function<void()>;
+    using Result = std::vector<unsigned char>;
+
+    struct WorkerContext
+    {
+        glbinding::ContextHandle handle;
+        ContextCallback makeCurrent;
+        ContextCallback doneCurrent;
+    };
+
+    struct Readback
+    {
+        Readback();
+
+        gl::GLenum attachment; ///< defaults to GL_COLOR_ATTACHMENT0
+        gl::GLenum format; ///< defaults to GL_RGBA
+        gl::GLenum type; ///< defaults to GL_UNSIGNED_BYTE
+        std::array<gl::GLint, 4> rect; ///< defaults to the whole target if width or height is 0
+    };
+
+    struct Job
+    {
+        Job(gl::GLsizei width, gl::GLsizei height, std::function<void(Framebuffer *)> render);
+
+        gl::GLsizei width;
+        gl::GLsizei height;
+        gl::GLenum colorFormat; ///< defaults to GL_RGBA8
+        gl::GLenum depthFormat; ///< defaults to GL_DEPTH_COMPONENT24, GL_NONE omits the depth attachment
+        std::function<void(Framebuffer *)> render;
+        Readback readback;
+    };
+
+
+public:
+    /** \brief Starts one worker per context; contexts are registered without sharing.
+    */
+    RenderJobScheduler(const std::vector<WorkerContext> & contexts, glbinding::GetProcAddress functionPointerResolver);
+
+    /** \brief Starts one worker per context; contexts share objects with sharedContextId.
+    */
+    RenderJobScheduler(const std::vector<WorkerContext> & contexts, glbinding::GetProcAddress functionPointerResolver, glbinding::ContextHandle sharedContextId);
+
+    /** \brief Finishes all submitted jobs and stops the workers.
+    */
+    virtual ~RenderJobScheduler();
+
+    std::future<Result> submit(Job job);
+
+    std::size_t workerCount() const;
+
+    /** \brief Number of submitted jobs that were not started yet.
+    */
+    std::size_t pendingCount() const;
+
+
+protected:
+    struct Task
+    {
+        Task(Job && job);
+
+        Job job;
+        std::promise<Result> promise;
+    };
+
+    struct Worker
+    {
+        WorkerContext context;
+        std::mutex mutex;
+        std::deque<Task> queue;
+        std::thread thread;
+    };
+
+
+protected:
+    void start(const std::vector<WorkerContext> & contexts);
+
+    bool take(std::size_t index, std::unique_ptr<Task> & task);
+    void run(std::size_t index);
+
+
+protected:
+    glbinding::GetProcAddress m_functionPointerResolver;
+    bool m_shareObjects;
+    glbinding::ContextHandle m_sharedContextId;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<std::size_t> m_next; ///< round-robin worker, submit() may be called from any thread
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::ptrdiff_t m_queued;
+    bool m_running;
+};
+
+
+} // namespace globjects
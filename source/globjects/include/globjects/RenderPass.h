@@ -0,0 +1,121 @@
+
+#pragma once
+
+
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Framebuffer;
+class FramebufferCache;
+
+
+/** \brief Describes how the attachments of a framebuffer are loaded and stored by a pass.
+
+    begin() binds the framebuffer, makes the color attachments its draw
+    buffers (in the order they were set), discards attachments whose
+    previous contents are not needed (LoadOp::DontCare) and clears
+    attachments with LoadOp::Clear. Depth and stencil are cleared with a
+    single call if both are cleared. end() discards attachments whose
+    contents are not needed after the pass (StoreOp::DontCare), which
+    saves the write-back on tile-based and bandwidth-limited GPUs.
+
+    Discarding requires GL 4.3 or GL_ARB_invalidate_subdata and is skipped
+    otherwise. Clears honor the scissor test and write masks. Color clear
+    values are passed as floats and thus suit normalized and float formats.
+
+    For the default framebuffer, the attachments are GL_COLOR, GL_DEPTH
+    and GL_STENCIL; its draw buffers are left untouched.
+
+    \code{.cpp}
+
+        auto pass = RenderPass::create(fbo.get());
+        pass->setColorAttachment(gl::GL_COLOR_ATTACHMENT0, RenderPass::LoadOp::Clear, RenderPass::StoreOp::Store);
+        pass->setDepthAttachment(RenderPass::LoadOp::Clear, RenderPass::StoreOp::DontCare);
+
+        pass->begin();
+        // draw calls
+        pass->end();
+
+    \endcode
+ */
+class GLOBJECTS_API RenderPass : public Instantiator<RenderPass>
+{
+public:
+    enum class LoadOp : unsigned int
+    {
+        Load,
+        Clear,
+        DontCare
+    };
+
+    enum class StoreOp : unsigned int
+    {
+        Store,
+        DontCare
+    };
+
+
+public:
+    /** \param cache if given, draw buffers are set through the cache to skip redundant calls
+    */
+    RenderPass(Framebuffer * framebuffer, FramebufferCache * cache = nullptr);
+    virtual ~RenderPass();
+
+    Framebuffer * framebuffer() const;
+
+    void setColorAttachment(gl::GLenum attachment, LoadOp load, StoreOp store, const glm::vec4 & clearColor = glm::vec4(0.0f));
+    void setDepthAttachment(LoadOp load, StoreOp store, float clearDepth = 1.0f);
+    void setStencilAttachment(LoadOp load, StoreOp store, gl::GLint clearStencil = 0);
+
+    void begin();
+    void end();
+
+
+protected:
+    struct Attachment
+    {
+        gl::GLenum attachment;
+        LoadOp load;
+        StoreOp store;
+    };
+
+
+protected:
+    /** \brief Discards the attachments not loaded (loading) or not stored.
+    */
+    void invalidate(bool loading);
+
+
+protected:
+    Framebuffer * m_framebuffer;
+    FramebufferCache * m_cache;
+    bool m_invalidateSupported;
+
+    std::vector<Attachment> m_colors;
+    std::vector<glm::vec4> m_clearColors;
+
+    bool m_hasDepth;
+    Attachment m_depth;
+    float m_clearDepth;
+
+    bool m_hasStencil;
+    Attachment m_stencil;
+    gl::GLint m_clearStencil;
+
+    std::vector<gl::GLenum> m_drawBuffers;
+    std::vector<gl::GLenum> m_invalidated; ///< scratch, avoids allocations per pass
+};
+
+
+} // namespace globjects
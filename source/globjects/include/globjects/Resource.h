@@ -74,6 +74,7 @@ class GLOBJECTS_API BufferResource : public IDResource
 {
 public:
     BufferResource();
+    BufferResource(gl::GLuint id);
     ~BufferResource();
 };
 
@@ -106,6 +107,7 @@ class GLOBJECTS_API QueryResource : public IDResource
 {
 public:
     QueryResource();
+    QueryResource(gl::GLuint id);
     ~QueryResource();
 };
 
@@ -138,6 +140,7 @@ class GLOBJECTS_API TextureResource : public IDResource
 {
 public:
     TextureResource(gl::GLenum target);
+    TextureResource(gl::GLuint id);
     ~TextureResource();
 };
 
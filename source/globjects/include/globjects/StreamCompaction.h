@@ -0,0 +1,83 @@
+
+#pragma once
+
+
+#include <memory>
+#include <string>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+class ComputeKernel;
+class PrefixScan;
+
+
+/** \brief Copies the elements of a buffer that satisfy a predicate, preserving their order.
+
+    The predicate is a GLSL expression over the element (value) and its
+    index (index), e.g., "value.w > 0.0". Elements may be of any GLSL type
+    with identical std430 layout in input and output; struct types are
+    declared through declarations.
+
+    compact() evaluates the predicate into a flag buffer, computes each
+    element's output position with an exclusive PrefixScan of the flags
+    and scatters the selected elements. The number of selected elements is
+    written to countBuffer() and stays on the GPU unless read with
+    readCount().
+
+    The shader storage binding points 0 to 4 are overwritten. Requires
+    GL 4.3.
+
+    \code{.cpp}
+
+        auto compaction = StreamCompaction::create("value.radius > 0.0", "Particle",
+            "struct Particle { vec4 position; float radius; float age; vec2 padding; };");
+
+        compaction->compact(particles.get(), alive.get(), particleCount);
+
+    \endcode
+ */
+class GLOBJECTS_API StreamCompaction : public Instantiator<StreamCompaction>
+{
+public:
+    StreamCompaction(const std::string & predicate, const std::string & elementType = "uint", const std::string & declarations = "");
+    virtual ~StreamCompaction();
+
+    /** \brief Writes the selected elements of the count first elements of input to output.
+    */
+    void compact(const Buffer * input, Buffer * output, gl::GLuint count);
+
+    /** \brief Holds the number of elements selected by the last compact() as a single uint.
+    */
+    Buffer * countBuffer() const;
+
+    /** \brief Reads the selected count back; waits for compact() to finish.
+    */
+    gl::GLuint readCount() const;
+
+
+protected:
+    void reserve(gl::GLuint count);
+
+
+protected:
+    std::unique_ptr<ComputeKernel> m_evaluate;
+    std::unique_ptr<ComputeKernel> m_scatter;
+    std::unique_ptr<PrefixScan> m_scan;
+
+    std::unique_ptr<Buffer> m_flags;
+    std::unique_ptr<Buffer> m_offsets;
+    std::unique_ptr<Buffer> m_count;
+    gl::GLuint m_capacity;
+};
+
+
+} // namespace globjects
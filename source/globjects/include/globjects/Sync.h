@@ -9,6 +9,7 @@
 #include <globjects/globjects_api.h>
 
 #include <globjects/base/Instantiator.h>
+#include <globjects/AsyncResult.h>
 
 
 namespace globjects
@@ -34,6 +35,25 @@ public:
 
     gl::GLsync sync() const;
 
+    /** \brief Replaces the wrapped sync object by a new fence, reusing this wrapper.
+    */
+    void renew(gl::GLenum condition);
+
+    /** \brief Non-blocking check whether the fence has been signaled.
+    */
+    bool isSignaled();
+
+    /** \brief Resolves to true once the fence is signaled, checked by the current context's AsyncPoller.
+        The Sync object has to outlive the pending result.
+    */
+    AsyncResult<bool> signaledAsync();
+
+    // awaiter protocol, allows co_await on a Sync object when compiled as C++20
+    bool await_ready();
+    template <typename Handle>
+    void await_suspend(Handle handle);
+    void await_resume() const;
+
 
 protected:
     void wait(gl::UnusedMask flags, gl::GLuint64 timeout);
@@ -49,3 +69,6 @@ protected:
 
 
 } // namespace globjects
+
+
+#include <globjects/Sync.inl>
@@ -0,0 +1,16 @@
+
+#pragma once
+
+
+namespace globjects
+{
+
+
+template <typename Handle>
+void Sync::await_suspend(Handle handle)
+{
+    signaledAsync().then([handle](const bool &) { handle.resume(); });
+}
+
+
+} // namespace globjects
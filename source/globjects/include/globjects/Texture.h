@@ -4,6 +4,8 @@
 
 #include <glbinding/gl/types.h>
 
+#include <memory>
+#include <set>
 #include <vector>
 
 #include <glm/fwd.hpp>
@@ -11,6 +13,7 @@
 #include <globjects/globjects_api.h>
 #include <globjects/Object.h>
 #include <globjects/base/Instantiator.h>
+#include <globjects/AsyncResult.h>
 
 
 namespace globjects 
@@ -18,6 +21,8 @@ namespace globjects
 
 
 class Buffer;
+class FramebufferCache;
+class Readback;
 class TextureHandle;
 class Sampler;
 
@@ -69,6 +74,10 @@ public:
     static std::unique_ptr<Texture> createDefault();
     static std::unique_ptr<Texture> createDefault(gl::GLenum target);
 
+    /** \brief Creates count textures with a single call to glGenTextures/glCreateTextures.
+    */
+    static std::vector<std::unique_ptr<Texture>> createMany(gl::GLenum target, gl::GLsizei count);
+
     void bind() const;
     void unbind() const;
     static void unbind(gl::GLenum target);
@@ -92,6 +101,22 @@ public:
     void getCompressedImage(gl::GLint lod, gl::GLvoid * image) const;
     std::vector<unsigned char> getCompressedImage(gl::GLint lod = 0) const;
 
+    /** \brief Reads back a level without stalling, through a pixel pack buffer that is fenced.
+        The current context's AsyncPoller resolves the result once the GPU is done.
+    */
+    AsyncResult<std::vector<unsigned char>> readAsync(gl::GLint level, gl::GLenum format, gl::GLenum type) const;
+
+    /** \brief Reads back a level into caller-owned, possibly uninitialized storage without stalling.
+        image has to stay valid until the result is resolved.
+    */
+    AsyncResult<bool> readAsync(gl::GLint level, gl::GLenum format, gl::GLenum type, gl::GLvoid * image) const;
+
+    /** \brief Reads back a level without stalling; the result is a read-only mapping of the pixel pack buffer.
+    */
+    AsyncResult<std::shared_ptr<const Readback>> readMappedAsync(gl::GLint level, gl::GLenum format, gl::GLenum type) const;
+
+    AsyncResult<std::vector<unsigned char>> readCompressedAsync(gl::GLint lod = 0) const;
+
     gl::GLenum target() const;
 
     void image1D(gl::GLint level, gl::GLenum internalFormat, gl::GLsizei width, gl::GLint border, gl::GLenum format, gl::GLenum type, const gl::GLvoid * data);
@@ -164,6 +189,11 @@ public:
 
     virtual gl::GLenum objectType() const override;
 
+    /** \brief Registers a cache that evicts its framebuffers referencing this texture on destruction.
+    */
+    void registerListener(FramebufferCache * listener);
+    void deregisterListener(FramebufferCache * listener);
+
 
 protected:
     Texture(std::unique_ptr<IDResource> && resource, gl::GLenum target);
@@ -171,6 +201,7 @@ protected:
 
 protected:
     gl::GLenum m_target;
+    std::set<FramebufferCache *> m_framebufferCacheListeners;
 };
 
 
@@ -0,0 +1,161 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class FrameFenceManager;
+class Object;
+class Renderbuffer;
+class Texture;
+
+
+/** \brief Recycles transient textures and renderbuffers, e.g., intermediate render targets.
+
+    obtainTexture() and obtainRenderbuffer() hand out objects with
+    immutable storage matching a Description, reusing a released object if
+    one matches. Objects are owned by the pool; release() returns them.
+    Parameters set on a texture by a previous user are kept.
+
+    If a FrameFenceManager is given, released objects become available
+    again only after the frame they were released in has been completed
+    by the GPU, so reuse never waits on pending rendering. Available
+    objects are evicted in least recently used order as soon as their
+    total size exceeds the budget.
+
+    \code{.cpp}
+
+        auto pool = TexturePool::create(fences.get(), 256 << 20);
+
+        // per frame
+        Texture * bloom = pool->obtainTexture({ gl::GL_TEXTURE_2D, gl::GL_RGBA16F, width / 2, height / 2 });
+        // render and sample
+        pool->release(bloom);
+
+    \endcode
+
+    \see FrameFenceManager
+ */
+class GLOBJECTS_API TexturePool : public Instantiator<TexturePool>
+{
+public:
+    struct Description
+    {
+        Description();
+        Description(gl::GLenum target, gl::GLenum internalFormat, gl::GLsizei width, gl::GLsizei height = 1, gl::GLsizei depth = 1, gl::GLsizei levels = 1, gl::GLsizei samples = 0);
+
+        bool operator==(const Description & other) const;
+
+        gl::GLenum target; ///< texture target, or GL_RENDERBUFFER
+        gl::GLenum internalFormat;
+        gl::GLsizei width;
+        gl::GLsizei height;
+        gl::GLsizei depth;
+        gl::GLsizei levels;
+        gl::GLsizei samples; ///< 0 for non-multisample storage
+    };
+
+    struct Statistics
+    {
+        std::size_t pooledBytes; ///< released objects, pending or available
+        std::size_t inUseBytes;
+        std::size_t peakBytes;   ///< maximum of pooled and in use bytes combined
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t evictions;
+
+        double hitRate() const;
+    };
+
+
+public:
+    /** \param fences delays reuse of released objects, may be nullptr
+        \param budget maximum size of available objects in bytes
+    */
+    TexturePool(FrameFenceManager * fences = nullptr, std::size_t budget = 256u << 20);
+    virtual ~TexturePool();
+
+    std::size_t budget() const;
+    void setBudget(std::size_t budget);
+
+    Texture * obtainTexture(const Description & description);
+    Renderbuffer * obtainRenderbuffer(gl::GLenum internalFormat, gl::GLsizei width, gl::GLsizei height, gl::GLsizei samples = 0);
+
+    void release(Texture * texture);
+    void release(Renderbuffer * renderbuffer);
+
+    /** \brief Makes objects released in completed frames available; called by obtain*().
+    */
+    void collect();
+
+    /** \brief Destroys all available objects.
+    */
+    void clear();
+
+    /** \brief Estimated storage size of an object matching description.
+    */
+    static std::size_t sizeInBytes(const Description & description);
+
+    const Statistics & statistics() const;
+    void resetStatistics();
+
+
+protected:
+    struct DescriptionHash
+    {
+        std::size_t operator()(const Description & description) const;
+    };
+
+    struct Entry
+    {
+        Object * object() const;
+
+        std::unique_ptr<Texture> texture;
+        std::unique_ptr<Renderbuffer> renderbuffer;
+        Description description;
+        std::size_t bytes;
+        std::uint64_t frame;    ///< frame of release, for pending entries
+        std::uint64_t lastUse;  ///< release order, for eviction
+    };
+
+
+protected:
+    Object * obtain(const Description & description);
+    void release(Object * object);
+
+    void makeAvailable(Entry entry);
+    void trim();
+    void updatePeak();
+
+    static void allocate(const Description & description, Entry & entry);
+
+
+protected:
+    FrameFenceManager * m_fences;
+    std::size_t m_budget;
+    std::size_t m_availableBytes;
+    std::uint64_t m_useCounter;
+
+    std::unordered_map<Description, std::vector<Entry>, DescriptionHash> m_available;
+    std::unordered_map<const Object *, Entry> m_inUse;
+    std::vector<Entry> m_pending;
+
+    Statistics m_statistics;
+};
+
+
+} // namespace globjects
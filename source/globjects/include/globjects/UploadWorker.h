@@ -0,0 +1,145 @@
+
+#pragma once
+
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <glbinding/ContextHandle.h>
+#include <glbinding/ProcAddress.h>
+#include <glbinding/gl/types.h>
+
+#include <globjects/globjects_api.h>
+#include <globjects/base/Instantiator.h>
+
+
+namespace globjects
+{
+
+
+class AbstractStringSource;
+class Buffer;
+class Shader;
+class Sync;
+class Texture;
+
+
+/** \brief Runs uploads and shader compiles on a background thread with a shared context.
+
+    The worker owns a thread on which the given context is made current and
+    registered as sharing objects with sharedContextId (see
+    globjects::registerContext()). Creating and activating the context is
+    windowing-system specific and therefore done through the makeCurrent and
+    doneCurrent callbacks, which are invoked on the worker thread.
+
+    Jobs run on the worker thread in submission order. After each job a Sync
+    fence is inserted and the commands are flushed. The resulting object is
+    handed back on the render thread from within collect(), which makes the
+    render context wait for the fence on the server (glWaitSync) before
+    invoking the job's callback. Thus, the object can be used right away
+    without stalling the CPU.
+
+    Only objects that are shared between contexts (buffers, textures,
+    shaders, programs, ...) can be created by jobs; container objects such as
+    VertexArray and Framebuffer have to be created on the render thread.
+
+    \code{.cpp}
+
+        auto worker = UploadWorker::create(workerContextHandle, getProcAddress, renderContextHandle,
+            [window]() { glfwMakeContextCurrent(window); },
+            []() { glfwMakeContextCurrent(nullptr); });
+
+        worker->uploadTexture(gl::GL_TEXTURE_2D, gl::GL_RGBA8, width, height, gl::GL_RGBA, gl::GL_UNSIGNED_BYTE, std::move(pixels),
+            [this](std::unique_ptr<Texture> texture) { m_texture = std::move(texture); });
+
+        // once per frame on the render thread
+        worker->collect();
+
+    \endcode
+ */
+class GLOBJECTS_API UploadWorker : public Instantiator<UploadWorker>
+{
+public:
+    using ContextCallback = std::function<void()>;
+
+    template <typename T>
+    using Job = std::function<std::unique_ptr<T>()>;
+
+    template <typename T>
+    using Callback = std::function<void(std::unique_ptr<T>)>;
+
+
+public:
+    UploadWorker(glbinding::ContextHandle contextHandle, glbinding::GetProcAddress functionPointerResolver, glbinding::ContextHandle sharedContextId, ContextCallback makeCurrent, ContextCallback doneCurrent);
+
+    /** \brief Finishes all submitted jobs and stops the worker thread.
+        Results that were not collected are discarded.
+    */
+    virtual ~UploadWorker();
+
+    /** \brief Runs job on the worker thread, callback is invoked with its result from within collect().
+    */
+    template <typename T>
+    void enqueue(Job<T> job, Callback<T> callback);
+
+    void uploadBuffer(std::vector<unsigned char> data, gl::GLenum usage, Callback<Buffer> callback);
+
+    void uploadTexture(gl::GLenum target, gl::GLenum internalFormat, gl::GLsizei width, gl::GLsizei height, gl::GLenum format, gl::GLenum type, std::vector<unsigned char> data, Callback<Texture> callback);
+
+    /** \brief Compiles a shader from source on the worker thread.
+        source has to outlive the shader.
+    */
+    void compileShader(gl::GLenum type, AbstractStringSource * source, Callback<Shader> callback);
+
+    /** \brief Hands back all finished results to the current (render) context.
+        \return number of invoked callbacks
+    */
+    std::size_t collect();
+
+    /** \brief Number of submitted jobs that were not collected yet.
+    */
+    std::size_t pendingCount() const;
+
+
+protected:
+    struct Task
+    {
+        std::function<void()> work;
+        std::function<void()> finish;
+        std::unique_ptr<Sync> fence;
+    };
+
+
+protected:
+    void submit(std::function<void()> work, std::function<void()> finish);
+
+    void run();
+
+
+protected:
+    glbinding::ContextHandle m_contextHandle;
+    glbinding::GetProcAddress m_functionPointerResolver;
+    glbinding::ContextHandle m_sharedContextId;
+    ContextCallback m_makeCurrent;
+    ContextCallback m_doneCurrent;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Task> m_queue;
+    std::vector<Task> m_finished;
+    std::size_t m_pending;
+    bool m_running;
+
+    std::thread m_thread;
+};
+
+
+} // namespace globjects
+
+
+#include <globjects/UploadWorker.inl>
@@ -0,0 +1,23 @@
+
+#pragma once
+
+
+namespace globjects
+{
+
+
+template <typename T>
+void UploadWorker::enqueue(Job<T> job, Callback<T> callback)
+{
+    // the result is produced on the worker thread and consumed on the render thread
+    auto result = std::make_shared<std::unique_ptr<T>>();
+
+    submit([job, result]() {
+        *result = job();
+    }, [callback, result]() {
+        callback(std::move(*result));
+    });
+}
+
+
+} // namespace globjects
@@ -24,6 +24,9 @@ class Buffer;
 // http://www.opengl.org/wiki/Vertex_Array_Object
 class GLOBJECTS_API VertexArray : public Object, public Instantiator<VertexArray>
 {
+    friend class DrawCommands;
+
+
 public:
     enum class AttributeImplementation
     {
@@ -66,6 +69,9 @@ public:
 
     void multiDrawArrays(gl::GLenum mode, gl::GLint * first, const gl::GLsizei * count, gl::GLsizei drawCount) const;
     void multiDrawArraysIndirect(gl::GLenum mode, const void * indirect, gl::GLsizei drawCount, gl::GLsizei stride) const;
+    /** \brief Reads the draw count from the buffer bound to GL_PARAMETER_BUFFER at offset drawCount (GL 4.6 or GL_ARB_indirect_parameters).
+    */
+    void multiDrawArraysIndirectCount(gl::GLenum mode, const void * indirect, gl::GLintptr drawCount, gl::GLsizei maxDrawCount, gl::GLsizei stride) const;
 
     void drawElements(gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices = nullptr) const;
     void drawElementsBaseVertex(gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices, gl::GLint baseVertex) const;
@@ -77,6 +83,9 @@ public:
     void multiDrawElements(gl::GLenum mode, const gl::GLsizei * count, gl::GLenum type, const void ** indices, gl::GLsizei drawCount) const;
     void multiDrawElementsBaseVertex(gl::GLenum mode, const gl::GLsizei * count, gl::GLenum type, const void ** indices, gl::GLsizei drawCount, gl::GLint * baseVertex) const;
     void multiDrawElementsIndirect(gl::GLenum mode, gl::GLenum type, const void * indirect, gl::GLsizei drawCount, gl::GLsizei stride) const;
+    /** \brief Reads the draw count from the buffer bound to GL_PARAMETER_BUFFER at offset drawCount (GL 4.6 or GL_ARB_indirect_parameters).
+    */
+    void multiDrawElementsIndirectCount(gl::GLenum mode, gl::GLenum type, const void * indirect, gl::GLintptr drawCount, gl::GLsizei maxDrawCount, gl::GLsizei stride) const;
 
     void drawRangeElements(gl::GLenum mode, gl::GLuint start, gl::GLuint end, gl::GLsizei count, gl::GLenum type, const void * indices = nullptr) const;
     void drawRangeElementsBaseVertex(gl::GLenum mode, gl::GLuint start, gl::GLuint end, gl::GLsizei count, gl::GLenum type, const void * indices, gl::GLint baseVertex) const;
@@ -105,15 +114,25 @@ public:
     void multiDrawElements(gl::GLenum mode, gl::GLenum type, const std::vector<MultiDrawElementsRange> & ranges) const;
     void multiDrawElementsBaseVertex(gl::GLenum mode, gl::GLenum type, const std::vector<MultiDrawElementsBaseVertexRange> & ranges) const;
 
+    // caller-owned structure-of-arrays spans of drawCount elements each, passed to OpenGL without copies
+    void multiDrawArrays(gl::GLenum mode, const gl::GLint * firsts, const gl::GLsizei * counts, gl::GLsizei drawCount) const;
+    void multiDrawElements(gl::GLenum mode, gl::GLenum type, const gl::GLsizei * counts, const void * const * indices, gl::GLsizei drawCount) const;
+    void multiDrawElementsBaseVertex(gl::GLenum mode, gl::GLenum type, const gl::GLsizei * counts, const void * const * indices, const gl::GLint * baseVertices, gl::GLsizei drawCount) const;
+
     virtual gl::GLenum objectType() const override;
 
 
 protected:
     VertexArray(std::unique_ptr<IDResource> && resource);
 
+    /** \brief Binds the vertex array and issues the memory barriers required by automatic barrier tracking.
+    */
+    void prepareDraw() const;
+
 
 protected:
     std::map<gl::GLuint, std::unique_ptr<VertexAttributeBinding>> m_bindings;
+    const Buffer * m_elementBuffer;
 
 };
 
@@ -50,6 +50,60 @@ GLOBJECTS_API void init(glbinding::ContextHandle contextHandle, glbinding::GetPr
 */
 GLOBJECTS_API void detachAllObjects();
 
+/** \brief Checks all pending asynchronous operations of the current context once
+    
+    Resolves AsyncResults (and resumes awaiting coroutines) whose GPU work has
+    completed. Call once per frame; it never blocks.
+    \return number of completed operations
+*/
+GLOBJECTS_API std::size_t pollAsync();
+
+/** \brief Enables deferred deletion of GL names for the current context
+    
+    Destroyed objects enqueue their names instead of deleting them
+    immediately. Queued names are deleted with one glDelete* call per
+    object type by flushDeletions() or flushDeletionsFenced(), which should
+    be called once per frame. Disabling does not flush the queue.
+*/
+GLOBJECTS_API void setDeferredDeletion(bool enabled);
+GLOBJECTS_API bool deferredDeletion();
+
+/** \brief Deletes all queued names (and fenced names whose fence has passed)
+    \return number of deleted names
+*/
+GLOBJECTS_API std::size_t flushDeletions();
+
+/** \brief Deletes the queued names once the GPU passed a fence inserted now
+    
+    The names are deleted by a later flushDeletions() or flushDeletionsFenced()
+    call. Names of previously fenced batches whose fence has passed are
+    deleted right away.
+    \return number of deleted names
+*/
+GLOBJECTS_API std::size_t flushDeletionsFenced();
+
+/** \brief Sets the number of buffer and texture names generated at once for the current context
+    
+    Names are drawn from a per-context pool that is refilled with a single
+    glGen*() or glCreate*() call. A batch size of 1, the default, disables
+    pooling. Lowering the batch size deletes unused names beyond the new
+    batch size.
+*/
+GLOBJECTS_API void setNamePoolBatchSize(gl::GLsizei batchSize);
+
+/** \brief Enables automatic memory barriers for the current context
+    
+    Buffers and textures bound for shader storage, atomic counter or image
+    writes are considered written by each following draw or dispatch. A
+    later read through globjects, e.g., as vertex or uniform buffer,
+    texture, indirect buffer or by an update, copy, map or pixel transfer,
+    issues glMemoryBarrier with only the bits of the reading paths. Only
+    bindings made through globjects while enabled are tracked, so enable
+    it before binding any resources.
+*/
+GLOBJECTS_API void setBarrierTracking(bool enabled);
+GLOBJECTS_API bool barrierTracking();
+
 template <typename T, typename... Args>
 void init(glbinding::GetProcAddress functionPointerResolver, T strategy, Args... args);
 
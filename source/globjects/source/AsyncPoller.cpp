@@ -0,0 +1,63 @@
+
+#include <globjects/AsyncPoller.h>
+
+#include "registry/Registry.h"
+
+
+namespace globjects
+{
+
+
+AsyncPoller::AsyncPoller()
+{
+}
+
+AsyncPoller::~AsyncPoller()
+{
+}
+
+AsyncPoller & AsyncPoller::current()
+{
+    return Registry::current().asyncPoller();
+}
+
+void AsyncPoller::add(Task task)
+{
+    m_tasks.push_back(std::move(task));
+}
+
+std::size_t AsyncPoller::poll()
+{
+    if (m_tasks.empty())
+    {
+        return 0;
+    }
+
+    // completed tasks may resume coroutines that add new tasks
+    std::vector<Task> tasks;
+    tasks.swap(m_tasks);
+
+    std::size_t completed = 0;
+
+    for (auto & task : tasks)
+    {
+        if (task())
+        {
+            ++completed;
+        }
+        else
+        {
+            m_tasks.push_back(std::move(task));
+        }
+    }
+
+    return completed;
+}
+
+std::size_t AsyncPoller::pendingCount() const
+{
+    return m_tasks.size();
+}
+
+
+} // namespace globjects
@@ -5,12 +5,15 @@
 
 #include <glbinding/gl/functions.h>
 #include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
 
 #include <globjects/globjects.h>
 
 #include "registry/ImplementationRegistry.h"
+#include "registry/BarrierTracker.h"
 
 #include <globjects/Resource.h>
+#include <globjects/Readback.h>
 
 #include "implementations/BufferImplementation_Legacy.h"
 
@@ -72,6 +75,28 @@ Buffer * Buffer::fromId(const GLuint id)
     return new Buffer(std::unique_ptr<IDResource>(new ExternalResource(id)));
 }
 
+std::vector<std::unique_ptr<Buffer>> Buffer::createMany(const GLsizei count)
+{
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    if (count <= 0)
+    {
+        return buffers;
+    }
+
+    std::vector<GLuint> ids(static_cast<std::size_t>(count));
+    implementation().create(count, ids.data());
+
+    buffers.reserve(ids.size());
+
+    for (const auto id : ids)
+    {
+        buffers.push_back(std::unique_ptr<Buffer>(new Buffer(std::unique_ptr<IDResource>(new BufferResource(id)))));
+    }
+
+    return buffers;
+}
+
 Buffer::~Buffer()
 {
 }
@@ -79,30 +104,42 @@ Buffer::~Buffer()
 void Buffer::bind(const GLenum target) const
 {
     glBindBuffer(target, id());
+
+    BarrierTracker::current().bindBuffer(target, id());
 }
 
 void Buffer::unbind(const GLenum target)
 {
     glBindBuffer(target, 0);
+
+    BarrierTracker::current().bindBuffer(target, 0);
 }
 
 void Buffer::unbind(const GLenum target, const GLuint index)
 {
     glBindBufferBase(target, index, 0);
+
+    BarrierTracker::current().bindBuffer(target, index, 0);
 }
 
 const void * Buffer::map() const
 {
+    BarrierTracker::current().bufferUpdate(id());
+
     return static_cast<const void*>(implementation().map(this, GL_READ_ONLY));
 }
 
 void* Buffer::map(const GLenum access)
 {
+    BarrierTracker::current().bufferUpdate(id());
+
     return implementation().map(this, access);
 }
 
 void* Buffer::mapRange(const GLintptr offset, const GLsizeiptr length, const MapBufferAccessMask access)
 {
+    BarrierTracker::current().bufferUpdate(id());
+
     return implementation().mapRange(this, offset, length, access);
 }
 
@@ -123,6 +160,8 @@ void Buffer::setData(const GLsizeiptr size, const GLvoid * data, const GLenum us
     
 void Buffer::setSubData(const GLintptr offset, const GLsizeiptr size, const GLvoid * data)
 {
+    BarrierTracker::current().bufferUpdate(id());
+
     implementation().setSubData(this, offset, size, data);
 }
 
@@ -144,17 +183,25 @@ GLint64 Buffer::getParameter64(const GLenum pname) const
 void Buffer::bindBase(const GLenum target, const GLuint index) const
 {
     glBindBufferBase(target, index, id());
+
+    BarrierTracker::current().bindBuffer(target, index, id());
 }
 
 void Buffer::bindRange(const GLenum target, const GLuint index, const GLintptr offset, const GLsizeiptr size) const
 {
     glBindBufferRange(target, index, id(), offset, size);
+
+    BarrierTracker::current().bindBuffer(target, index, id());
 }
 
 void Buffer::copySubData(Buffer * buffer, const GLintptr readOffset, const GLintptr writeOffset, const GLsizeiptr size) const
 {
     assert(buffer != nullptr);
 
+    BarrierTracker & tracker = BarrierTracker::current();
+    tracker.read(BarrierTracker::Type::Buffer, buffer->id(), GL_BUFFER_UPDATE_BARRIER_BIT);
+    tracker.bufferUpdate(id());
+
     implementation().copySubData(this, buffer, readOffset, writeOffset, size);
 }
 
@@ -173,11 +220,15 @@ void Buffer::copyData(Buffer * buffer, const GLsizeiptr size, const GLenum usage
 
 void Buffer::clearData(const GLenum internalformat, const GLenum format, const GLenum type, const void * data)
 {
+    BarrierTracker::current().bufferUpdate(id());
+
     implementation().clearData(this, internalformat, format, type, data);
 }
 
 void Buffer::clearSubData(const GLenum internalformat, const GLintptr offset, const GLsizeiptr size, const GLenum format, const GLenum type, const void * data)
 {
+    BarrierTracker::current().bufferUpdate(id());
+
     implementation().clearSubData(this, internalformat, offset, size, format, type, data);
 }
 
@@ -203,9 +254,32 @@ void * Buffer::getPointer(const GLenum pname)
 
 void Buffer::getSubData(const GLintptr offset, const GLsizeiptr size, void * data) const
 {
+    BarrierTracker::current().bufferUpdate(id());
+
     implementation().getBufferSubData(this, offset, size, data);
 }
 
+AsyncResult<std::vector<unsigned char>> Buffer::readAsync(const GLintptr offset, const GLsizeiptr size) const
+{
+    return Readback::toVector(readMappedAsync(offset, size));
+}
+
+AsyncResult<bool> Buffer::readAsync(const GLintptr offset, const GLsizeiptr size, void * data) const
+{
+    return Readback::copyTo(readMappedAsync(offset, size), data);
+}
+
+AsyncResult<std::shared_ptr<const Readback>> Buffer::readMappedAsync(const GLintptr offset, const GLsizeiptr size) const
+{
+    // shared, as std::function requires copyable captures
+    std::shared_ptr<Buffer> staging = Buffer::create();
+    staging->setData(size, nullptr, GL_STREAM_READ);
+
+    copySubData(staging.get(), offset, 0, size);
+
+    return Readback::fenced(staging, size);
+}
+
 void Buffer::invalidateData() const
 {
     implementation().invalidateData(this);
@@ -0,0 +1,683 @@
+
+#include <globjects/CommandList.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/Framebuffer.h>
+#include <globjects/Program.h>
+#include <globjects/State.h>
+#include <globjects/Texture.h>
+#include <globjects/VertexArray.h>
+
+#include "DrawCommands.h"
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+const std::size_t alignment = alignof(std::max_align_t);
+
+std::size_t aligned(const std::size_t size)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+
+enum class CommandType : std::uint32_t
+{
+    UseProgram
+,   BindVertexArray
+,   BindFramebuffer
+,   BindBuffer
+,   BindBufferBase
+,   BindBufferRange
+,   BindTexture
+,   SetUniform
+,   ApplyState
+,   DrawArrays
+,   DrawElements
+,   MultiDrawElementsIndirect
+,   DispatchCompute
+,   MemoryBarrier
+,   Call
+};
+
+
+struct CommandHeader
+{
+    CommandType type;
+    std::uint32_t size; // including header, payload and padding
+};
+
+
+struct UseProgramCommand
+{
+    static const CommandType s_type = CommandType::UseProgram;
+
+    CommandHeader header;
+    globjects::Program * program; // nullptr releases the program
+};
+
+struct BindVertexArrayCommand
+{
+    static const CommandType s_type = CommandType::BindVertexArray;
+
+    CommandHeader header;
+    const globjects::VertexArray * vertexArray;
+};
+
+struct BindFramebufferCommand
+{
+    static const CommandType s_type = CommandType::BindFramebuffer;
+
+    CommandHeader header;
+    const globjects::Framebuffer * framebuffer;
+    GLenum target;
+};
+
+struct BindBufferCommand
+{
+    static const CommandType s_type = CommandType::BindBuffer;
+
+    CommandHeader header;
+    const globjects::Buffer * buffer;
+    GLenum target;
+};
+
+struct BindBufferBaseCommand
+{
+    static const CommandType s_type = CommandType::BindBufferBase;
+
+    CommandHeader header;
+    const globjects::Buffer * buffer;
+    GLenum target;
+    GLuint index;
+};
+
+struct BindBufferRangeCommand
+{
+    static const CommandType s_type = CommandType::BindBufferRange;
+
+    CommandHeader header;
+    const globjects::Buffer * buffer;
+    GLenum target;
+    GLuint index;
+    GLintptr offset;
+    GLsizeiptr size;
+};
+
+struct BindTextureCommand
+{
+    static const CommandType s_type = CommandType::BindTexture;
+
+    CommandHeader header;
+    const globjects::Texture * texture;
+    GLuint unit;
+};
+
+struct SetUniformCommand
+{
+    static const CommandType s_type = CommandType::SetUniform;
+
+    CommandHeader header;
+    globjects::Program * program;
+    globjects::CommandList::UniformSetter setter;
+    GLint location;
+    std::uint32_t nameOffset; // of the null-terminated name from the command, 0 for location based uniforms
+    // followed by the aligned value and name
+};
+
+struct ApplyStateCommand
+{
+    static const CommandType s_type = CommandType::ApplyState;
+
+    CommandHeader header;
+    globjects::State * state;
+};
+
+struct DrawArraysCommand
+{
+    static const CommandType s_type = CommandType::DrawArrays;
+
+    CommandHeader header;
+    const globjects::VertexArray * vertexArray;
+    GLenum mode;
+    GLint first;
+    GLsizei count;
+    GLsizei instanceCount;
+    GLuint baseInstance;
+};
+
+struct DrawElementsCommand
+{
+    static const CommandType s_type = CommandType::DrawElements;
+
+    CommandHeader header;
+    const globjects::VertexArray * vertexArray;
+    GLenum mode;
+    GLsizei count;
+    GLenum type;
+    const void * indices;
+    GLsizei instanceCount;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+struct MultiDrawElementsIndirectCommand
+{
+    static const CommandType s_type = CommandType::MultiDrawElementsIndirect;
+
+    CommandHeader header;
+    const globjects::VertexArray * vertexArray;
+    GLenum mode;
+    GLenum type;
+    const void * indirect;
+    GLsizei drawCount;
+    GLsizei stride;
+};
+
+struct DispatchComputeCommand
+{
+    static const CommandType s_type = CommandType::DispatchCompute;
+
+    CommandHeader header;
+    globjects::Program * program;
+    GLuint numGroupsX;
+    GLuint numGroupsY;
+    GLuint numGroupsZ;
+};
+
+struct MemoryBarrierCommand
+{
+    static const CommandType s_type = CommandType::MemoryBarrier;
+
+    CommandHeader header;
+    MemoryBarrierMask barriers;
+};
+
+struct CallCommand
+{
+    static const CommandType s_type = CommandType::Call;
+
+    CommandHeader header;
+    std::size_t function; // index into the list's functions
+};
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+struct CommandList::Shadow
+{
+    Shadow()
+    {
+        invalidate();
+    }
+
+    void invalidate()
+    {
+        programKnown = false;
+        program = nullptr;
+        vertexArrayKnown = false;
+        vertexArray = nullptr;
+        drawFramebuffer = nullptr;
+        readFramebuffer = nullptr;
+        textures.clear();
+    }
+
+    bool programKnown;
+    const Program * program;
+
+    bool vertexArrayKnown;
+    const VertexArray * vertexArray;
+
+    const Framebuffer * drawFramebuffer;
+    const Framebuffer * readFramebuffer;
+
+    std::unordered_map<GLuint, const Texture *> textures;
+};
+
+
+CommandList::CommandList()
+: m_currentBlock(0)
+, m_commandCount(0)
+{
+}
+
+CommandList::~CommandList()
+{
+}
+
+void CommandList::reset()
+{
+    for (auto & block : m_blocks)
+    {
+        block.size = 0;
+    }
+
+    m_currentBlock = 0;
+    m_commandCount = 0;
+
+    m_functions.clear();
+}
+
+bool CommandList::empty() const
+{
+    return m_commandCount == 0;
+}
+
+std::size_t CommandList::commandCount() const
+{
+    return m_commandCount;
+}
+
+void * CommandList::allocate(std::size_t size)
+{
+    size = aligned(size);
+
+    while (m_currentBlock < m_blocks.size() && m_blocks[m_currentBlock].size + size > m_blocks[m_currentBlock].capacity)
+    {
+        // a reused block may be too small for an oversized command
+        if (m_blocks[m_currentBlock].size == 0)
+        {
+            break;
+        }
+
+        ++m_currentBlock;
+    }
+
+    if (m_currentBlock == m_blocks.size() || m_blocks[m_currentBlock].capacity < size)
+    {
+        Block block;
+        block.capacity = std::max(s_blockSize, size);
+        block.data.reset(new unsigned char[block.capacity]);
+        block.size = 0;
+
+        m_blocks.insert(m_blocks.begin() + static_cast<std::ptrdiff_t>(m_currentBlock), std::move(block));
+    }
+
+    Block & block = m_blocks[m_currentBlock];
+
+    void * result = block.data.get() + block.size;
+    block.size += size;
+
+    return result;
+}
+
+template <typename Command>
+Command * CommandList::record()
+{
+    Command * command = static_cast<Command *>(allocate(sizeof(Command)));
+
+    command->header.type = Command::s_type;
+    command->header.size = static_cast<std::uint32_t>(aligned(sizeof(Command)));
+
+    ++m_commandCount;
+
+    return command;
+}
+
+void CommandList::useProgram(Program * program)
+{
+    record<UseProgramCommand>()->program = program;
+}
+
+void CommandList::releaseProgram()
+{
+    record<UseProgramCommand>()->program = nullptr;
+}
+
+void CommandList::bindVertexArray(const VertexArray * vertexArray)
+{
+    record<BindVertexArrayCommand>()->vertexArray = vertexArray;
+}
+
+void CommandList::bindFramebuffer(const Framebuffer * framebuffer, const GLenum target)
+{
+    auto command = record<BindFramebufferCommand>();
+    command->framebuffer = framebuffer;
+    command->target = target;
+}
+
+void CommandList::bindBuffer(const Buffer * buffer, const GLenum target)
+{
+    auto command = record<BindBufferCommand>();
+    command->buffer = buffer;
+    command->target = target;
+}
+
+void CommandList::bindBufferBase(const Buffer * buffer, const GLenum target, const GLuint index)
+{
+    auto command = record<BindBufferBaseCommand>();
+    command->buffer = buffer;
+    command->target = target;
+    command->index = index;
+}
+
+void CommandList::bindBufferRange(const Buffer * buffer, const GLenum target, const GLuint index, const GLintptr offset, const GLsizeiptr size)
+{
+    auto command = record<BindBufferRangeCommand>();
+    command->buffer = buffer;
+    command->target = target;
+    command->index = index;
+    command->offset = offset;
+    command->size = size;
+}
+
+void CommandList::bindTexture(const Texture * texture, const GLuint unit)
+{
+    auto command = record<BindTextureCommand>();
+    command->texture = texture;
+    command->unit = unit;
+}
+
+void CommandList::recordUniform(Program * program, const GLint location, const std::string * name, const void * value, const std::size_t size, const UniformSetter setter)
+{
+    const std::size_t valueOffset = aligned(sizeof(SetUniformCommand));
+    const std::size_t nameOffset = valueOffset + aligned(size);
+    const std::size_t total = nameOffset + (name != nullptr ? aligned(name->size() + 1) : 0);
+
+    auto command = static_cast<SetUniformCommand *>(allocate(total));
+    command->header.type = SetUniformCommand::s_type;
+    command->header.size = static_cast<std::uint32_t>(total);
+    command->program = program;
+    command->setter = setter;
+    command->location = location;
+    command->nameOffset = name != nullptr ? static_cast<std::uint32_t>(nameOffset) : 0u;
+
+    unsigned char * data = reinterpret_cast<unsigned char *>(command);
+
+    std::memcpy(data + valueOffset, value, size);
+
+    // the name is copied into the arena as well, so recording does not allocate
+    if (name != nullptr)
+    {
+        std::memcpy(data + nameOffset, name->c_str(), name->size() + 1);
+    }
+
+    ++m_commandCount;
+}
+
+void CommandList::applyState(State * state)
+{
+    record<ApplyStateCommand>()->state = state;
+}
+
+void CommandList::drawArrays(const VertexArray * vertexArray, const GLenum mode, const GLint first, const GLsizei count, const GLsizei instanceCount, const GLuint baseInstance)
+{
+    auto command = record<DrawArraysCommand>();
+    command->vertexArray = vertexArray;
+    command->mode = mode;
+    command->first = first;
+    command->count = count;
+    command->instanceCount = instanceCount;
+    command->baseInstance = baseInstance;
+}
+
+void CommandList::drawElements(const VertexArray * vertexArray, const GLenum mode, const GLsizei count, const GLenum type, const void * indices, const GLsizei instanceCount, const GLint baseVertex, const GLuint baseInstance)
+{
+    auto command = record<DrawElementsCommand>();
+    command->vertexArray = vertexArray;
+    command->mode = mode;
+    command->count = count;
+    command->type = type;
+    command->indices = indices;
+    command->instanceCount = instanceCount;
+    command->baseVertex = baseVertex;
+    command->baseInstance = baseInstance;
+}
+
+void CommandList::multiDrawElementsIndirect(const VertexArray * vertexArray, const GLenum mode, const GLenum type, const void * indirect, const GLsizei drawCount, const GLsizei stride)
+{
+    auto command = record<MultiDrawElementsIndirectCommand>();
+    command->vertexArray = vertexArray;
+    command->mode = mode;
+    command->type = type;
+    command->indirect = indirect;
+    command->drawCount = drawCount;
+    command->stride = stride;
+}
+
+void CommandList::dispatchCompute(Program * program, const GLuint numGroupsX, const GLuint numGroupsY, const GLuint numGroupsZ)
+{
+    auto command = record<DispatchComputeCommand>();
+    command->program = program;
+    command->numGroupsX = numGroupsX;
+    command->numGroupsY = numGroupsY;
+    command->numGroupsZ = numGroupsZ;
+}
+
+void CommandList::memoryBarrier(const MemoryBarrierMask barriers)
+{
+    record<MemoryBarrierCommand>()->barriers = barriers;
+}
+
+void CommandList::call(std::function<void()> function)
+{
+    record<CallCommand>()->function = m_functions.size();
+    m_functions.push_back(std::move(function));
+}
+
+void CommandList::execute() const
+{
+    Shadow shadow;
+
+    replay(shadow);
+}
+
+void CommandList::execute(const std::vector<const CommandList *> & lists)
+{
+    Shadow shadow;
+
+    for (const CommandList * list : lists)
+    {
+        assert(list != nullptr);
+
+        list->replay(shadow);
+    }
+}
+
+void CommandList::replay(Shadow & shadow) const
+{
+    const auto bindVertexArray = [&shadow](const VertexArray * vertexArray) {
+        if (shadow.vertexArrayKnown && shadow.vertexArray == vertexArray)
+        {
+            return;
+        }
+
+        vertexArray->bind();
+
+        shadow.vertexArrayKnown = true;
+        shadow.vertexArray = vertexArray;
+    };
+
+    for (const auto & block : m_blocks)
+    {
+        std::size_t offset = 0;
+
+        while (offset < block.size)
+        {
+            const unsigned char * data = block.data.get() + offset;
+            const auto header = reinterpret_cast<const CommandHeader *>(data);
+
+            offset += header->size;
+
+            switch (header->type)
+            {
+            case CommandType::UseProgram:
+                {
+                    const auto command = reinterpret_cast<const UseProgramCommand *>(data);
+
+                    if (shadow.programKnown && shadow.program == command->program)
+                    {
+                        break;
+                    }
+
+                    if (command->program)
+                    {
+                        command->program->use();
+                    }
+                    else
+                    {
+                        Program::release();
+                    }
+
+                    shadow.programKnown = true;
+                    shadow.program = command->program;
+                }
+                break;
+
+            case CommandType::BindVertexArray:
+                bindVertexArray(reinterpret_cast<const BindVertexArrayCommand *>(data)->vertexArray);
+                break;
+
+            case CommandType::BindFramebuffer:
+                {
+                    const auto command = reinterpret_cast<const BindFramebufferCommand *>(data);
+
+                    const bool draw = command->target == GL_FRAMEBUFFER || command->target == GL_DRAW_FRAMEBUFFER;
+                    const bool read = command->target == GL_FRAMEBUFFER || command->target == GL_READ_FRAMEBUFFER;
+
+                    if ((!draw || shadow.drawFramebuffer == command->framebuffer) && (!read || shadow.readFramebuffer == command->framebuffer))
+                    {
+                        break;
+                    }
+
+                    command->framebuffer->bind(command->target);
+
+                    if (draw)
+                        shadow.drawFramebuffer = command->framebuffer;
+                    if (read)
+                        shadow.readFramebuffer = command->framebuffer;
+                }
+                break;
+
+            case CommandType::BindBuffer:
+                {
+                    const auto command = reinterpret_cast<const BindBufferCommand *>(data);
+                    command->buffer->bind(command->target);
+                }
+                break;
+
+            case CommandType::BindBufferBase:
+                {
+                    const auto command = reinterpret_cast<const BindBufferBaseCommand *>(data);
+                    command->buffer->bindBase(command->target, command->index);
+                }
+                break;
+
+            case CommandType::BindBufferRange:
+                {
+                    const auto command = reinterpret_cast<const BindBufferRangeCommand *>(data);
+                    command->buffer->bindRange(command->target, command->index, command->offset, command->size);
+                }
+                break;
+
+            case CommandType::BindTexture:
+                {
+                    const auto command = reinterpret_cast<const BindTextureCommand *>(data);
+
+                    const auto it = shadow.textures.find(command->unit);
+
+                    if (it != shadow.textures.end() && it->second == command->texture)
+                    {
+                        break;
+                    }
+
+                    command->texture->bindActive(command->unit);
+                    shadow.textures[command->unit] = command->texture;
+                }
+                break;
+
+            case CommandType::SetUniform:
+                {
+                    const auto command = reinterpret_cast<const SetUniformCommand *>(data);
+                    const void * value = data + aligned(sizeof(SetUniformCommand));
+                    const char * name = command->nameOffset != 0 ? reinterpret_cast<const char *>(data + command->nameOffset) : nullptr;
+
+                    command->setter(command->program, command->location, name, value);
+
+                    // uniform implementations without direct state access bind the program
+                    shadow.programKnown = false;
+                }
+                break;
+
+            case CommandType::ApplyState:
+                reinterpret_cast<const ApplyStateCommand *>(data)->state->apply();
+                break;
+
+            case CommandType::DrawArrays:
+                {
+                    const auto command = reinterpret_cast<const DrawArraysCommand *>(data);
+
+                    bindVertexArray(command->vertexArray);
+
+                    DrawCommands::drawArrays(command->vertexArray, command->mode, command->first, command->count, command->instanceCount, command->baseInstance);
+                }
+                break;
+
+            case CommandType::DrawElements:
+                {
+                    const auto command = reinterpret_cast<const DrawElementsCommand *>(data);
+
+                    bindVertexArray(command->vertexArray);
+
+                    DrawCommands::drawElements(command->vertexArray, command->mode, command->count, command->type, command->indices, command->instanceCount, command->baseVertex, command->baseInstance);
+                }
+                break;
+
+            case CommandType::MultiDrawElementsIndirect:
+                {
+                    const auto command = reinterpret_cast<const MultiDrawElementsIndirectCommand *>(data);
+
+                    bindVertexArray(command->vertexArray);
+                    DrawCommands::prepare(command->vertexArray);
+
+                    glMultiDrawElementsIndirect(command->mode, command->type, command->indirect, command->drawCount, command->stride);
+                }
+                break;
+
+            case CommandType::DispatchCompute:
+                {
+                    const auto command = reinterpret_cast<const DispatchComputeCommand *>(data);
+
+                    command->program->dispatchCompute(command->numGroupsX, command->numGroupsY, command->numGroupsZ);
+
+                    shadow.programKnown = true;
+                    shadow.program = command->program;
+                }
+                break;
+
+            case CommandType::MemoryBarrier:
+                glMemoryBarrier(reinterpret_cast<const MemoryBarrierCommand *>(data)->barriers);
+                break;
+
+            case CommandType::Call:
+                m_functions[reinterpret_cast<const CallCommand *>(data)->function]();
+
+                // arbitrary code may change any binding
+                shadow.invalidate();
+                break;
+            }
+        }
+    }
+}
+
+
+} // namespace globjects
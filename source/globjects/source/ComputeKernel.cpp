@@ -0,0 +1,95 @@
+
+#include "ComputeKernel.h"
+
+#include <algorithm>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+#include <globjects/Program.h>
+#include <globjects/Shader.h>
+#include <globjects/base/StaticStringSource.h>
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+const GLuint maxGroupCountX = 65535; // minimum guaranteed GL_MAX_COMPUTE_WORK_GROUP_COUNT
+
+// GL_KHR_shader_subgroup, not necessarily known to glbinding
+const GLenum subgroupSupportedStages = static_cast<GLenum>(0x9533);
+const GLenum subgroupSupportedFeatures = static_cast<GLenum>(0x9534);
+const GLint subgroupFeatureArithmetic = 0x0004;
+const GLint computeShaderStage = 0x0020;
+
+
+const char * const prelude = R"(
+uint groupIndex()
+{
+    return gl_WorkGroupID.x + gl_WorkGroupID.y * gl_NumWorkGroups.x;
+}
+)";
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+ComputeKernel::ComputeKernel(const std::string & defines, const char * body)
+: m_source(Shader::sourceFromString("#version 430\n" + defines + prelude + body))
+, m_shader(Shader::create(GL_COMPUTE_SHADER, m_source.get()))
+, m_program(Program::create())
+{
+    m_program->attach(m_shader.get());
+}
+
+ComputeKernel::~ComputeKernel()
+{
+}
+
+Program * ComputeKernel::program() const
+{
+    return m_program.get();
+}
+
+void ComputeKernel::dispatch(const GLuint groupCount) const
+{
+    if (groupCount == 0)
+    {
+        return;
+    }
+
+    const GLuint x = std::min(groupCount, maxGroupCountX);
+    const GLuint y = (groupCount + x - 1) / x;
+
+    m_program->dispatchCompute(x, y, 1);
+}
+
+void ComputeKernel::dispatchIndirect(const Buffer * arguments, const GLintptr offset) const
+{
+    arguments->bind(GL_DISPATCH_INDIRECT_BUFFER);
+
+    m_program->dispatchComputeIndirect(offset);
+}
+
+bool ComputeKernel::subgroupArithmeticSupported()
+{
+    if (!hasExtension("GL_KHR_shader_subgroup"))
+    {
+        return false;
+    }
+
+    return (getInteger(subgroupSupportedStages) & computeShaderStage) != 0
+        && (getInteger(subgroupSupportedFeatures) & subgroupFeatureArithmetic) != 0;
+}
+
+
+} // namespace globjects
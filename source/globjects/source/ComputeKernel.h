@@ -0,0 +1,48 @@
+
+#pragma once
+
+
+#include <memory>
+#include <string>
+
+#include <glbinding/gl/types.h>
+
+
+namespace globjects
+{
+
+
+class Buffer;
+class Program;
+class Shader;
+class StaticStringSource;
+
+
+// Compute program generated from source, owning its source and shader.
+// Kernels compute their flattened work group index with groupIndex(), as
+// dispatch() spreads group counts beyond the per-dimension limit over y.
+class ComputeKernel
+{
+public:
+    ComputeKernel(const std::string & defines, const char * body);
+    virtual ~ComputeKernel();
+
+    Program * program() const;
+
+    void dispatch(gl::GLuint groupCount) const;
+
+    // group counts as written by a kernel, x wrapped like in dispatch()
+    void dispatchIndirect(const Buffer * arguments, gl::GLintptr offset) const;
+
+    // GL_KHR_shader_subgroup with arithmetic operations in compute shaders
+    static bool subgroupArithmeticSupported();
+
+
+protected:
+    std::unique_ptr<StaticStringSource> m_source;
+    std::unique_ptr<Shader> m_shader;
+    std::unique_ptr<Program> m_program;
+};
+
+
+} // namespace globjects
@@ -0,0 +1,296 @@
+
+#include <globjects/CullingStage.h>
+
+#include <array>
+#include <cassert>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/extension.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+#include <globjects/Program.h>
+#include <globjects/Shader.h>
+#include <globjects/Texture.h>
+#include <globjects/VertexArray.h>
+#include <globjects/base/StaticStringSource.h>
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+const char * const cullingSource = R"(
+#version 430
+
+layout (local_size_x = 64) in;
+
+struct Object
+{
+    vec4 sphere;
+    uint count;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+struct Command
+{
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout (std430, binding = 0) readonly buffer Objects { Object objects[]; };
+layout (std430, binding = 1) writeonly buffer Commands { Command commands[]; };
+layout (std430, binding = 2) buffer DrawCount { uint drawCount; };
+
+uniform uint objectCount;
+uniform vec4 planes[6];
+uniform mat4 viewProjection;
+uniform bool compact;
+uniform bool occlusion;
+uniform sampler2D hiZ;
+
+bool insideFrustum(vec4 sphere)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        if (dot(planes[i].xyz, sphere.xyz) + planes[i].w < -sphere.w)
+            return false;
+    }
+    return true;
+}
+
+bool unoccluded(vec4 sphere)
+{
+    vec3 lower = vec3(1.0);
+    vec3 upper = vec3(0.0);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        vec3 corner = sphere.xyz + sphere.w * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = viewProjection * vec4(corner, 1.0);
+
+        // bounds crossing the near plane cannot be projected conservatively
+        if (clip.w <= 0.0)
+            return true;
+
+        vec3 window = clip.xyz / clip.w * 0.5 + 0.5;
+        lower = min(lower, window);
+        upper = max(upper, window);
+    }
+
+    lower.xy = clamp(lower.xy, 0.0, 1.0);
+    upper.xy = clamp(upper.xy, 0.0, 1.0);
+
+    // the level at which the bounds cover at most 2x2 texels; rounding of odd
+    // level sizes may need one more level
+    vec2 extent = (upper.xy - lower.xy) * vec2(textureSize(hiZ, 0));
+    int maxLevel = textureQueryLevels(hiZ) - 1;
+    int level = min(int(ceil(log2(max(max(extent.x, extent.y), 1.0)))), maxLevel);
+
+    ivec2 lowerTexel;
+    ivec2 upperTexel;
+
+    for (;; ++level)
+    {
+        ivec2 size = textureSize(hiZ, level);
+        lowerTexel = clamp(ivec2(lower.xy * vec2(size)), ivec2(0), size - 1);
+        upperTexel = clamp(ivec2(upper.xy * vec2(size)), ivec2(0), size - 1);
+
+        if (level == maxLevel || all(lessThanEqual(upperTexel - lowerTexel, ivec2(1))))
+            break;
+    }
+
+    // texel fetches ignore the texture's filter, which must not interpolate between maxima
+    float farthest = max(
+        max(texelFetch(hiZ, lowerTexel, level).r, texelFetch(hiZ, ivec2(upperTexel.x, lowerTexel.y), level).r),
+        max(texelFetch(hiZ, ivec2(lowerTexel.x, upperTexel.y), level).r, texelFetch(hiZ, upperTexel, level).r));
+
+    return lower.z <= farthest;
+}
+
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+
+    if (index >= objectCount)
+        return;
+
+    Object object = objects[index];
+
+    bool visible = insideFrustum(object.sphere) && (!occlusion || unoccluded(object.sphere));
+
+    Command command = Command(object.count, 1u, object.firstIndex, object.baseVertex, object.baseInstance);
+
+    if (compact)
+    {
+        if (visible)
+            commands[atomicAdd(drawCount, 1u)] = command;
+    }
+    else
+    {
+        command.instanceCount = visible ? 1u : 0u;
+        commands[index] = command;
+    }
+}
+)";
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+CullingStage::CullingStage()
+: m_source(Shader::sourceFromString(cullingSource))
+, m_shader(Shader::create(GL_COMPUTE_SHADER, m_source.get()))
+, m_program(Program::create())
+, m_commands(Buffer::create())
+, m_drawCount(Buffer::create())
+, m_capacity(0)
+, m_objectCount(0)
+, m_compact(hasExtension(GLextension::GL_ARB_indirect_parameters))
+, m_hiZ(nullptr)
+{
+    m_program->attach(m_shader.get());
+
+    m_program->setUniform("compact", m_compact);
+    m_program->setUniform("occlusion", false);
+    m_program->setUniform("hiZ", 0);
+
+    m_drawCount->setData(static_cast<GLsizeiptr>(sizeof(GLuint)), nullptr, GL_DYNAMIC_DRAW);
+}
+
+CullingStage::~CullingStage()
+{
+}
+
+void CullingStage::setViewProjection(const glm::mat4 & viewProjection)
+{
+    // Gribb/Hartmann plane extraction, normalized for sphere distances
+    const glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+    const glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+    const glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+    const glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+    std::array<glm::vec4, 6> planes {{ row3 + row0, row3 - row0, row3 + row1, row3 - row1, row3 + row2, row3 - row2 }};
+
+    for (auto & plane : planes)
+    {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    m_program->setUniform("planes", planes);
+    m_program->setUniform("viewProjection", viewProjection);
+}
+
+void CullingStage::setHiZ(const Texture * hiZ)
+{
+    m_hiZ = hiZ;
+
+    m_program->setUniform("occlusion", m_hiZ != nullptr);
+}
+
+void CullingStage::cull(const Buffer * objects, const GLuint objectCount)
+{
+    assert(objects != nullptr);
+
+    reserve(objectCount);
+
+    m_objectCount = objectCount;
+
+    if (objectCount == 0)
+    {
+        return;
+    }
+
+    if (m_compact)
+    {
+        const GLuint zero = 0;
+        m_drawCount->setSubData(0, static_cast<GLsizeiptr>(sizeof(GLuint)), &zero);
+    }
+
+    objects->bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+    m_commands->bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+    m_drawCount->bindBase(GL_SHADER_STORAGE_BUFFER, 2);
+
+    if (m_hiZ)
+    {
+        m_hiZ->bindActive(0u);
+    }
+
+    m_program->setUniform("objectCount", objectCount);
+    m_program->dispatchCompute((objectCount + s_groupSize - 1) / s_groupSize, 1, 1);
+
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void CullingStage::draw(const VertexArray * vertexArray, const GLenum mode, const GLenum type) const
+{
+    if (m_objectCount == 0)
+    {
+        return;
+    }
+
+    m_commands->bind(GL_DRAW_INDIRECT_BUFFER);
+
+    if (m_compact)
+    {
+        m_drawCount->bind(GL_PARAMETER_BUFFER);
+
+        vertexArray->multiDrawElementsIndirectCount(mode, type, nullptr, 0, static_cast<GLsizei>(m_objectCount), 0);
+    }
+    else
+    {
+        vertexArray->multiDrawElementsIndirect(mode, type, nullptr, static_cast<GLsizei>(m_objectCount), 0);
+    }
+}
+
+bool CullingStage::compacts() const
+{
+    return m_compact;
+}
+
+Buffer * CullingStage::commands() const
+{
+    return m_commands.get();
+}
+
+Buffer * CullingStage::drawCount() const
+{
+    return m_drawCount.get();
+}
+
+Program * CullingStage::program() const
+{
+    return m_program.get();
+}
+
+void CullingStage::reserve(const GLuint objectCount)
+{
+    if (objectCount <= m_capacity)
+    {
+        return;
+    }
+
+    // one DrawElementsIndirectCommand (5 uints) per object
+    m_capacity = std::max(objectCount, m_capacity * 2);
+    m_commands->setData(static_cast<GLsizeiptr>(m_capacity) * 5 * static_cast<GLsizeiptr>(sizeof(GLuint)), nullptr, GL_DYNAMIC_DRAW);
+}
+
+
+} // namespace globjects
@@ -0,0 +1,73 @@
+
+#include "DrawCommands.h"
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/VertexArray.h>
+#include <globjects/VertexAttributeBinding.h>
+
+#include "registry/BarrierTracker.h"
+
+
+using namespace gl;
+
+
+namespace globjects
+{
+
+
+void DrawCommands::prepare(const VertexArray * vertexArray)
+{
+    BarrierTracker & tracker = BarrierTracker::current();
+
+    if (!tracker.isEnabled())
+    {
+        return;
+    }
+
+    for (const auto & pair : vertexArray->m_bindings)
+    {
+        if (const Buffer * buffer = pair.second->buffer())
+        {
+            tracker.read(BarrierTracker::Type::Buffer, buffer->id(), GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+        }
+    }
+
+    if (vertexArray->m_elementBuffer)
+    {
+        tracker.read(BarrierTracker::Type::Buffer, vertexArray->m_elementBuffer->id(), GL_ELEMENT_ARRAY_BARRIER_BIT);
+    }
+
+    tracker.command();
+}
+
+void DrawCommands::drawArrays(const VertexArray * vertexArray, const GLenum mode, const GLint first, const GLsizei count, const GLsizei instanceCount, const GLuint baseInstance)
+{
+    prepare(vertexArray);
+
+    if (baseInstance != 0)
+        glDrawArraysInstancedBaseInstance(mode, first, count, instanceCount, baseInstance);
+    else if (instanceCount != 1)
+        glDrawArraysInstanced(mode, first, count, instanceCount);
+    else
+        glDrawArrays(mode, first, count);
+}
+
+void DrawCommands::drawElements(const VertexArray * vertexArray, const GLenum mode, const GLsizei count, const GLenum type, const void * indices, const GLsizei instanceCount, const GLint baseVertex, const GLuint baseInstance)
+{
+    prepare(vertexArray);
+
+    if (baseInstance != 0)
+        glDrawElementsInstancedBaseVertexBaseInstance(mode, count, type, indices, instanceCount, baseVertex, baseInstance);
+    else if (instanceCount != 1)
+        glDrawElementsInstancedBaseVertex(mode, count, type, indices, instanceCount, baseVertex);
+    else if (baseVertex != 0)
+        glDrawElementsBaseVertex(mode, count, type, indices, baseVertex);
+    else
+        glDrawElements(mode, count, type, indices);
+}
+
+
+} // namespace globjects
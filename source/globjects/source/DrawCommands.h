@@ -0,0 +1,30 @@
+
+#pragma once
+
+
+#include <glbinding/gl/types.h>
+
+
+namespace globjects
+{
+
+
+class VertexArray;
+
+
+// Issues a single draw with the least specific glDraw*() call that supports
+// its parameters; shared by VertexArray and the batching layers (CommandList,
+// DrawQueue), which bind their vertex arrays themselves. Every draw goes
+// through prepare(), so automatic barrier tracking sees batched draws too.
+class DrawCommands
+{
+public:
+    // issues the memory barriers required by automatic barrier tracking for a draw from vertexArray
+    static void prepare(const VertexArray * vertexArray);
+
+    static void drawArrays(const VertexArray * vertexArray, gl::GLenum mode, gl::GLint first, gl::GLsizei count, gl::GLsizei instanceCount, gl::GLuint baseInstance);
+    static void drawElements(const VertexArray * vertexArray, gl::GLenum mode, gl::GLsizei count, gl::GLenum type, const void * indices, gl::GLsizei instanceCount, gl::GLint baseVertex, gl::GLuint baseInstance);
+};
+
+
+} // namespace globjects
@@ -0,0 +1,410 @@
+
+#include <globjects/DrawQueue.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Program.h>
+#include <globjects/State.h>
+#include <globjects/Texture.h>
+#include <globjects/VertexArray.h>
+
+#include "DrawCommands.h"
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+// key layout, from the most significant bit
+const unsigned layerShift = 56;        //  8 bits
+const unsigned transparentShift = 55;  //  1 bit
+
+const unsigned programBits = 12;
+const unsigned stateBits = 10;
+const unsigned textureSetBits = 12;
+const unsigned vertexArrayBits = 11;
+const unsigned depthBits = 10;
+
+const unsigned depthShift = 0;
+const unsigned vertexArrayShift = depthShift + depthBits;
+const unsigned textureSetShift = vertexArrayShift + vertexArrayBits;
+const unsigned stateShift = textureSetShift + textureSetBits;
+const unsigned programShift = stateShift + stateBits;
+
+const unsigned transparentDepthBits = 24;
+const unsigned transparentDepthShift = transparentShift - transparentDepthBits;
+
+static_assert(programShift + programBits == transparentShift, "opaque key fields must fill the bits below the transparency flag");
+
+
+std::uint64_t field(const std::uint32_t value, const unsigned bits, const unsigned shift)
+{
+    // ids beyond the field's range share the largest value; draws still render correctly, only sorted coarser
+    const std::uint64_t max = (std::uint64_t(1) << bits) - 1;
+
+    return std::min<std::uint64_t>(value, max) << shift;
+}
+
+std::uint32_t quantize(const float depth, const unsigned bits)
+{
+    const float max = static_cast<float>((std::uint64_t(1) << bits) - 1);
+
+    return static_cast<std::uint32_t>(std::max(0.0f, std::min(depth, 1.0f)) * max + 0.5f);
+}
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+DrawQueue::Draw::Draw(const VertexArray * vertexArray, Program * program, const GLenum mode, const GLint first, const GLsizei count)
+: vertexArray(vertexArray)
+, program(program)
+, state(nullptr)
+, textureSet(0)
+, layer(0)
+, transparent(false)
+, depth(0.0f)
+, mode(mode)
+, type(GL_NONE)
+, first(first)
+, count(count)
+, indices(nullptr)
+, instanceCount(1)
+, baseVertex(0)
+, baseInstance(0)
+, userData(nullptr)
+{
+}
+
+DrawQueue::Draw::Draw(const VertexArray * vertexArray, Program * program, const GLenum mode, const GLsizei count, const GLenum type, const void * indices)
+: vertexArray(vertexArray)
+, program(program)
+, state(nullptr)
+, textureSet(0)
+, layer(0)
+, transparent(false)
+, depth(0.0f)
+, mode(mode)
+, type(type)
+, first(0)
+, count(count)
+, indices(indices)
+, instanceCount(1)
+, baseVertex(0)
+, baseInstance(0)
+, userData(nullptr)
+{
+}
+
+DrawQueue::DrawQueue()
+: m_sorted(true)
+, m_textureSetDenseIdCount(0)
+, m_transparentDepthSorting(false)
+, m_statistics()
+{
+    clearTextureSets();
+}
+
+DrawQueue::~DrawQueue()
+{
+}
+
+std::uint32_t DrawQueue::textureSet(const std::vector<const Texture *> & textures)
+{
+    const auto it = m_textureSetIds.find(textures);
+
+    if (it != m_textureSetIds.end())
+    {
+        return it->second;
+    }
+
+    const auto id = static_cast<std::uint32_t>(m_textureSets.size());
+
+    m_textureSets.push_back(textures);
+    m_textureSetIds.emplace(textures, id);
+    m_textureSetDenseIds.push_back(0u);
+
+    return id;
+}
+
+void DrawQueue::clearTextureSets()
+{
+    assert(m_draws.empty());
+
+    m_textureSets.clear();
+    m_textureSetIds.clear();
+    m_textureSetDenseIds.clear();
+
+    // texture set 0 is the empty set
+    m_textureSets.emplace_back();
+    m_textureSetIds.emplace(std::vector<const Texture *>(), 0u);
+    m_textureSetDenseIds.push_back(0u);
+}
+
+void DrawQueue::setDrawCallback(DrawCallback callback)
+{
+    m_drawCallback = std::move(callback);
+}
+
+void DrawQueue::setTransparentDepthSorting(const bool enabled)
+{
+    m_transparentDepthSorting = enabled;
+}
+
+bool DrawQueue::transparentDepthSorting() const
+{
+    return m_transparentDepthSorting;
+}
+
+template <typename T>
+std::uint32_t DrawQueue::denseId(std::unordered_map<const T *, std::uint32_t> & ids, const T * object)
+{
+    if (object == nullptr)
+    {
+        return 0;
+    }
+
+    // 0 is reserved for nullptr
+    return ids.emplace(object, static_cast<std::uint32_t>(ids.size() + 1)).first->second;
+}
+
+std::uint32_t DrawQueue::textureSetId(const std::uint32_t textureSet)
+{
+    // 0 is reserved for the empty set
+    if (textureSet == 0)
+    {
+        return 0;
+    }
+
+    std::uint32_t & id = m_textureSetDenseIds[textureSet];
+
+    if (id == 0)
+    {
+        id = ++m_textureSetDenseIdCount;
+    }
+
+    return id;
+}
+
+std::uint64_t DrawQueue::key(const Draw & draw)
+{
+    std::uint64_t result = std::uint64_t(draw.layer) << layerShift;
+
+    if (draw.transparent)
+    {
+        result |= std::uint64_t(1) << transparentShift;
+
+        // equal keys keep their submission order
+        if (!m_transparentDepthSorting)
+        {
+            return result;
+        }
+
+        // back-to-front
+        const std::uint32_t depth = (std::uint32_t(1) << transparentDepthBits) - 1 - quantize(draw.depth, transparentDepthBits);
+
+        return result | (std::uint64_t(depth) << transparentDepthShift);
+    }
+
+    result |= field(denseId(m_programIds, draw.program), programBits, programShift);
+    result |= field(denseId(m_stateIds, draw.state), stateBits, stateShift);
+    result |= field(textureSetId(draw.textureSet), textureSetBits, textureSetShift);
+    result |= field(denseId(m_vertexArrayIds, draw.vertexArray), vertexArrayBits, vertexArrayShift);
+    result |= field(quantize(draw.depth, depthBits), depthBits, depthShift);
+
+    return result;
+}
+
+void DrawQueue::submit(const Draw & draw)
+{
+    assert(draw.vertexArray != nullptr);
+    assert(draw.program != nullptr);
+    assert(draw.textureSet < m_textureSets.size());
+
+    m_entries.push_back({ key(draw), static_cast<std::uint32_t>(m_draws.size()) });
+    m_draws.push_back(draw);
+
+    m_sorted = false;
+}
+
+void DrawQueue::sort()
+{
+    if (m_sorted)
+    {
+        return;
+    }
+
+    const std::size_t count = m_entries.size();
+
+    // one histogram per 8 bit digit, gathered in a single pass
+    std::array<std::array<std::size_t, 256>, 8> histograms;
+
+    for (auto & histogram : histograms)
+    {
+        histogram.fill(0);
+    }
+
+    for (const auto & entry : m_entries)
+    {
+        for (unsigned digit = 0; digit < 8; ++digit)
+        {
+            ++histograms[digit][(entry.key >> (digit * 8)) & 0xff];
+        }
+    }
+
+    m_scratch.resize(count);
+
+    for (unsigned digit = 0; digit < 8; ++digit)
+    {
+        auto & histogram = histograms[digit];
+
+        // all keys share this digit (e.g., unused layers), the pass would not change the order
+        if (histogram[(m_entries.front().key >> (digit * 8)) & 0xff] == count)
+        {
+            continue;
+        }
+
+        std::size_t offset = 0;
+
+        for (auto & bucket : histogram)
+        {
+            const std::size_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+
+        for (const auto & entry : m_entries)
+        {
+            m_scratch[histogram[(entry.key >> (digit * 8)) & 0xff]++] = entry;
+        }
+
+        m_entries.swap(m_scratch);
+    }
+
+    m_sorted = true;
+}
+
+void DrawQueue::execute()
+{
+    m_statistics = Statistics();
+
+    if (m_entries.empty())
+    {
+        return;
+    }
+
+    sort();
+
+    const Program * program = nullptr;
+    const State * state = nullptr;
+    const VertexArray * vertexArray = nullptr;
+    std::uint32_t textureSet = 0;
+
+    for (const auto & entry : m_entries)
+    {
+        const Draw & draw = m_draws[entry.index];
+
+        if (draw.program != program)
+        {
+            draw.program->use();
+            program = draw.program;
+
+            ++m_statistics.programChanges;
+        }
+
+        if (draw.state != nullptr && draw.state != state)
+        {
+            draw.state->apply();
+            state = draw.state;
+
+            ++m_statistics.stateChanges;
+        }
+
+        if (draw.textureSet != textureSet)
+        {
+            bindTextureSet(draw.textureSet);
+            textureSet = draw.textureSet;
+
+            ++m_statistics.textureSetChanges;
+        }
+
+        if (draw.vertexArray != vertexArray)
+        {
+            draw.vertexArray->bind();
+            vertexArray = draw.vertexArray;
+
+            ++m_statistics.vertexArrayChanges;
+        }
+
+        if (m_drawCallback)
+        {
+            m_drawCallback(draw);
+        }
+
+        issue(draw);
+
+        ++m_statistics.draws;
+    }
+}
+
+void DrawQueue::clear()
+{
+    m_draws.clear();
+    m_entries.clear();
+
+    // ids are assigned anew each frame, so objects that are no longer drawn do not take up key space
+    m_programIds.clear();
+    m_stateIds.clear();
+    m_vertexArrayIds.clear();
+
+    std::fill(m_textureSetDenseIds.begin(), m_textureSetDenseIds.end(), 0u);
+    m_textureSetDenseIdCount = 0;
+
+    m_sorted = true;
+}
+
+std::size_t DrawQueue::size() const
+{
+    return m_draws.size();
+}
+
+const DrawQueue::Statistics & DrawQueue::statistics() const
+{
+    return m_statistics;
+}
+
+void DrawQueue::bindTextureSet(const std::uint32_t textureSet) const
+{
+    const auto & textures = m_textureSets[textureSet];
+
+    for (std::size_t i = 0; i < textures.size(); ++i)
+    {
+        textures[i]->bindActive(static_cast<GLuint>(i));
+    }
+}
+
+void DrawQueue::issue(const Draw & draw)
+{
+    if (draw.type == GL_NONE)
+    {
+        DrawCommands::drawArrays(draw.vertexArray, draw.mode, draw.first, draw.count, draw.instanceCount, draw.baseInstance);
+    }
+    else
+    {
+        DrawCommands::drawElements(draw.vertexArray, draw.mode, draw.count, draw.type, draw.indices, draw.instanceCount, draw.baseVertex, draw.baseInstance);
+    }
+}
+
+
+} // namespace globjects
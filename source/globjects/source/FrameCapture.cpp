@@ -0,0 +1,257 @@
+
+#include <globjects/FrameCapture.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/values.h>
+#include <glbinding/gl/extension.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+#include <globjects/Framebuffer.h>
+#include <globjects/Sync.h>
+
+#include "pixelformat.h"
+
+
+using namespace gl;
+
+
+namespace globjects
+{
+
+
+FrameCapture::FrameCapture(Framebuffer * framebuffer, const std::array<GLint, 4> & rect, const GLenum format, const GLenum type, Callback callback, const std::size_t ringSize)
+: m_framebuffer(framebuffer)
+, m_rect(rect)
+, m_format(format)
+, m_type(type)
+, m_callback(std::move(callback))
+, m_rowSize(0)
+, m_size(imageSizeInBytes(rect[2], rect[3], 1, format, type))
+, m_persistent(false)
+, m_slots(ringSize)
+, m_next(0)
+, m_frame(0)
+, m_dropped(0)
+, m_running(true)
+{
+    assert(framebuffer != nullptr);
+    assert(m_callback);
+    assert(ringSize > 0);
+    assert(rect[2] > 0 && rect[3] > 0 && m_size > 0);
+
+    m_rowSize = static_cast<std::size_t>(m_size) / static_cast<std::size_t>(rect[3]);
+
+    const bool bufferStorage = hasExtension(GLextension::GL_ARB_buffer_storage);
+
+    for (auto & slot : m_slots)
+    {
+        slot.buffer = Buffer::create();
+        slot.data = nullptr;
+        slot.frame = 0;
+        slot.state = State::Free;
+
+        if (bufferStorage)
+        {
+            slot.buffer->setStorage(m_size, nullptr, GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+            slot.data = static_cast<const unsigned char *>(slot.buffer->mapRange(0, m_size, GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
+        }
+        else
+        {
+            slot.buffer->setData(m_size, nullptr, GL_STREAM_READ);
+        }
+    }
+
+    m_persistent = bufferStorage;
+
+    m_thread = std::thread(&FrameCapture::run, this);
+}
+
+FrameCapture::~FrameCapture()
+{
+    finish();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_running = false;
+    }
+
+    m_condition.notify_one();
+    m_thread.join();
+
+    if (m_persistent)
+    {
+        for (auto & slot : m_slots)
+        {
+            slot.buffer->unmap();
+        }
+    }
+}
+
+bool FrameCapture::capture()
+{
+    update(false);
+
+    const std::uint64_t frame = m_frame++;
+
+    Slot & slot = m_slots[m_next];
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (slot.state != State::Free)
+        {
+            ++m_dropped;
+
+            return false;
+        }
+    }
+
+    m_framebuffer->readPixelsToBuffer(m_rect, m_format, m_type, slot.buffer.get());
+
+    slot.fence = Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE);
+    slot.frame = frame;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        slot.state = State::Reading;
+    }
+
+    m_next = (m_next + 1) % m_slots.size();
+
+    return true;
+}
+
+void FrameCapture::finish()
+{
+    update(true);
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_delivered.wait(lock, [this]() {
+            return std::none_of(m_slots.begin(), m_slots.end(), [](const Slot & slot) { return slot.state == State::Delivering; });
+        });
+    }
+
+    update(false);
+}
+
+std::size_t FrameCapture::rowSize() const
+{
+    return m_rowSize;
+}
+
+std::uint64_t FrameCapture::capturedFrames() const
+{
+    return m_frame - m_dropped;
+}
+
+std::uint64_t FrameCapture::droppedFrames() const
+{
+    return m_dropped;
+}
+
+void FrameCapture::update(const bool wait)
+{
+    // only the worker changes states, from Delivering to Delivered, so GL calls need no lock
+    bool delivering = true;
+
+    for (std::size_t i = 0; i < m_slots.size(); ++i)
+    {
+        const std::size_t index = (m_next + i) % m_slots.size();
+        Slot & slot = m_slots[index];
+
+        State state;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            state = slot.state;
+        }
+
+        if (state == State::Delivered)
+        {
+            if (!m_persistent)
+            {
+                slot.buffer->unmap();
+                slot.data = nullptr;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            slot.state = State::Free;
+        }
+        else if (state == State::Reading && delivering)
+        {
+            // zero timeout polls; the flush makes sure the fence reaches the GPU at all
+            const GLenum status = slot.fence->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, wait ? GL_TIMEOUT_IGNORED : 0);
+
+            // keep frames in order
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            {
+                delivering = false;
+
+                continue;
+            }
+
+            slot.fence.reset();
+
+            if (!m_persistent)
+            {
+                slot.data = static_cast<const unsigned char *>(slot.buffer->mapRange(0, m_size, GL_MAP_READ_BIT));
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                slot.state = State::Delivering;
+                m_queue.push_back(index);
+            }
+
+            m_condition.notify_one();
+        }
+    }
+}
+
+void FrameCapture::run()
+{
+    while (true)
+    {
+        Frame frame;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_condition.wait(lock, [this]() { return !m_running || !m_queue.empty(); });
+
+            if (m_queue.empty())
+            {
+                break;
+            }
+
+            const Slot & slot = m_slots[m_queue.front()];
+            frame = Frame{ slot.frame, m_rect[2], m_rect[3], m_rowSize, slot.data };
+        }
+
+        m_callback(frame);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_slots[m_queue.front()].state = State::Delivered;
+            m_queue.pop_front();
+        }
+
+        m_delivered.notify_all();
+    }
+}
+
+
+} // namespace globjects
@@ -0,0 +1,246 @@
+
+#include <globjects/FrameFenceManager.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/values.h>
+
+#include <globjects/Sync.h>
+
+
+using namespace gl;
+
+
+namespace globjects
+{
+
+
+FrameFenceManager::FrameFenceManager(const std::size_t framesInFlight)
+: m_slots(std::max<std::size_t>(framesInFlight, 1))
+, m_frame(0)
+, m_inFrame(false)
+{
+    for (auto & slot : m_slots)
+    {
+        slot.frame = 0;
+        slot.pending = false;
+    }
+
+    resetStatistics();
+}
+
+FrameFenceManager::~FrameFenceManager()
+{
+}
+
+std::size_t FrameFenceManager::framesInFlight() const
+{
+    return m_slots.size();
+}
+
+std::uint64_t FrameFenceManager::beginFrame()
+{
+    assert(!m_inFrame);
+
+    Slot & current = slot(m_frame);
+
+    if (current.pending)
+    {
+        wait(current.frame);
+    }
+
+    m_inFrame = true;
+
+    return m_frame;
+}
+
+void FrameFenceManager::endFrame()
+{
+    assert(m_inFrame);
+
+    Slot & current = slot(m_frame);
+
+    if (current.fence)
+    {
+        current.fence->renew(GL_SYNC_GPU_COMMANDS_COMPLETE);
+    }
+    else
+    {
+        current.fence = Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE);
+    }
+
+    current.frame = m_frame;
+    current.pending = true;
+    current.callbacks.swap(m_deferred);
+
+    m_inFrame = false;
+    ++m_frame;
+}
+
+std::uint64_t FrameFenceManager::currentFrame() const
+{
+    return m_frame;
+}
+
+bool FrameFenceManager::isComplete(const std::uint64_t frame)
+{
+    if (!isTracked(frame))
+    {
+        return frame < m_frame;
+    }
+
+    Slot & s = slot(frame);
+
+    if (s.pending && s.fence->isSignaled())
+    {
+        retire(s);
+    }
+
+    return !s.pending;
+}
+
+bool FrameFenceManager::wait(const std::uint64_t frame)
+{
+    return wait(frame, GL_TIMEOUT_IGNORED);
+}
+
+bool FrameFenceManager::wait(const std::uint64_t frame, const GLuint64 timeout)
+{
+    // a frame that has not ended yet has no fence to wait for
+    assert(frame < m_frame);
+
+    if (!isTracked(frame))
+    {
+        return frame < m_frame;
+    }
+
+    Slot & s = slot(frame);
+
+    if (!s.pending)
+    {
+        return true;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const GLenum result = s.fence->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    const auto end = std::chrono::steady_clock::now();
+
+    if (result == GL_CONDITION_SATISFIED || result == GL_TIMEOUT_EXPIRED)
+    {
+        // time blocked until a timeout is a stall as well
+        const auto duration = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+
+        m_statistics.waitTime += duration;
+        m_statistics.maxWaitTime = std::max(m_statistics.maxWaitTime, duration);
+    }
+
+    if (result == GL_CONDITION_SATISFIED)
+    {
+        ++m_statistics.waitCount;
+    }
+    else if (result == GL_TIMEOUT_EXPIRED)
+    {
+        ++m_statistics.timeouts;
+
+        return false;
+    }
+    else if (result == GL_WAIT_FAILED)
+    {
+        return false;
+    }
+
+    retire(s);
+
+    return true;
+}
+
+void FrameFenceManager::finish()
+{
+    for (auto & s : m_slots)
+    {
+        if (s.pending)
+        {
+            wait(s.frame);
+        }
+    }
+}
+
+void FrameFenceManager::defer(Callback callback)
+{
+    // the ring slot of the current frame may still be in use by an older frame
+    m_deferred.push_back(std::move(callback));
+}
+
+void FrameFenceManager::defer(const std::uint64_t frame, Callback callback)
+{
+    if (frame == m_frame)
+    {
+        defer(std::move(callback));
+
+        return;
+    }
+
+    assert(frame < m_frame);
+
+    if (isComplete(frame))
+    {
+        callback();
+
+        return;
+    }
+
+    slot(frame).callbacks.push_back(std::move(callback));
+}
+
+void FrameFenceManager::collect()
+{
+    for (auto & s : m_slots)
+    {
+        if (s.pending && s.fence->isSignaled())
+        {
+            retire(s);
+        }
+    }
+}
+
+const FrameFenceManager::Statistics & FrameFenceManager::statistics() const
+{
+    return m_statistics;
+}
+
+void FrameFenceManager::resetStatistics()
+{
+    m_statistics = Statistics{ 0, 0, 0, 0 };
+}
+
+FrameFenceManager::Slot & FrameFenceManager::slot(const std::uint64_t frame)
+{
+    return m_slots[static_cast<std::size_t>(frame % m_slots.size())];
+}
+
+bool FrameFenceManager::isTracked(const std::uint64_t frame) const
+{
+    // frames older than the ring have been waited for by beginFrame()
+    return frame < m_frame && m_frame - frame <= m_slots.size();
+}
+
+void FrameFenceManager::retire(Slot & s)
+{
+    s.pending = false;
+
+    // callbacks may defer further work, which must not invalidate the iteration
+    std::vector<Callback> callbacks;
+    callbacks.swap(s.callbacks);
+
+    for (auto & callback : callbacks)
+    {
+        callback();
+    }
+}
+
+
+} // namespace globjects
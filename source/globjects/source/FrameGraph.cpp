@@ -0,0 +1,681 @@
+
+#include <globjects/FrameGraph.h>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/extension.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+#include <globjects/Framebuffer.h>
+#include <globjects/FramebufferCache.h>
+#include <globjects/Texture.h>
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+const std::size_t s_unused = std::numeric_limits<std::size_t>::max();
+
+
+unsigned int barrierBits(const globjects::FrameGraph::Access access)
+{
+    using Access = globjects::FrameGraph::Access;
+
+    switch (access)
+    {
+    case Access::Sampled:
+        return static_cast<unsigned int>(GL_TEXTURE_FETCH_BARRIER_BIT);
+    case Access::Image:
+        return static_cast<unsigned int>(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    case Access::ShaderStorage:
+        return static_cast<unsigned int>(GL_SHADER_STORAGE_BARRIER_BIT);
+    case Access::Uniform:
+        return static_cast<unsigned int>(GL_UNIFORM_BARRIER_BIT);
+    case Access::Indirect:
+        return static_cast<unsigned int>(GL_COMMAND_BARRIER_BIT);
+    case Access::Vertex:
+        return static_cast<unsigned int>(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT)
+            | static_cast<unsigned int>(GL_ELEMENT_ARRAY_BARRIER_BIT);
+    case Access::Transfer:
+        return static_cast<unsigned int>(GL_BUFFER_UPDATE_BARRIER_BIT)
+            | static_cast<unsigned int>(GL_TEXTURE_UPDATE_BARRIER_BIT)
+            | static_cast<unsigned int>(GL_PIXEL_BUFFER_BARRIER_BIT);
+    case Access::Attachment:
+        return static_cast<unsigned int>(GL_FRAMEBUFFER_BARRIER_BIT);
+    default:
+        return 0u;
+    }
+}
+
+bool isIncoherent(const globjects::FrameGraph::Access access)
+{
+    return access == globjects::FrameGraph::Access::Image || access == globjects::FrameGraph::Access::ShaderStorage;
+}
+
+unsigned int allBarrierBits()
+{
+    using Access = globjects::FrameGraph::Access;
+
+    unsigned int bits = 0u;
+
+    for (const Access access : { Access::Sampled, Access::Image, Access::ShaderStorage, Access::Uniform,
+        Access::Indirect, Access::Vertex, Access::Transfer, Access::Attachment })
+    {
+        bits |= barrierBits(access);
+    }
+
+    return bits;
+}
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+FrameGraph::PassBuilder::PassBuilder(FrameGraph & graph, const std::size_t pass)
+: m_graph(graph)
+, m_pass(pass)
+{
+}
+
+FrameGraph::Resource FrameGraph::PassBuilder::createTexture(const std::string & name, const TexturePool::Description & description)
+{
+    assert(description.target != GL_RENDERBUFFER);
+
+    const Resource resource = m_graph.addResource(name, true, false);
+    m_graph.m_resources[resource].description = description;
+
+    return resource;
+}
+
+FrameGraph::Resource FrameGraph::PassBuilder::createBuffer(const std::string & name, const GLsizeiptr size)
+{
+    assert(size > 0);
+
+    const Resource resource = m_graph.addResource(name, false, false);
+    m_graph.m_resources[resource].size = size;
+
+    return resource;
+}
+
+void FrameGraph::PassBuilder::read(const Resource resource, const Access access)
+{
+    assert(resource < m_graph.m_resources.size());
+
+    m_graph.m_passes[m_pass].uses.push_back(Use{ resource, access, false });
+}
+
+void FrameGraph::PassBuilder::write(const Resource resource, const Access access)
+{
+    assert(resource < m_graph.m_resources.size());
+
+    m_graph.m_passes[m_pass].uses.push_back(Use{ resource, access, true });
+}
+
+void FrameGraph::PassBuilder::attach(const Resource resource, const GLenum attachment, const GLint level, const GLint layer)
+{
+    assert(resource < m_graph.m_resources.size());
+    assert(m_graph.m_resources[resource].isTexture);
+
+    PassNode & pass = m_graph.m_passes[m_pass];
+
+    // previous contents may be loaded, blended or depth tested against
+    pass.uses.push_back(Use{ resource, Access::Attachment, false });
+    pass.uses.push_back(Use{ resource, Access::Attachment, true });
+    pass.attachments.push_back(AttachmentUse{ resource, attachment, level, layer });
+}
+
+void FrameGraph::PassBuilder::setSideEffect()
+{
+    m_graph.m_passes[m_pass].sideEffect = true;
+}
+
+FrameGraph::PassContext::PassContext(const FrameGraph & graph, Framebuffer * framebuffer)
+: m_graph(graph)
+, m_framebuffer(framebuffer)
+{
+}
+
+Texture * FrameGraph::PassContext::texture(const Resource resource) const
+{
+    assert(resource < m_graph.m_resources.size());
+
+    return m_graph.m_resources[resource].texture;
+}
+
+Buffer * FrameGraph::PassContext::buffer(const Resource resource) const
+{
+    assert(resource < m_graph.m_resources.size());
+
+    return m_graph.m_resources[resource].buffer;
+}
+
+Framebuffer * FrameGraph::PassContext::framebuffer() const
+{
+    return m_framebuffer;
+}
+
+bool FrameGraph::AttachmentUse::operator==(const AttachmentUse & other) const
+{
+    return resource == other.resource && attachment == other.attachment && level == other.level && layer == other.layer;
+}
+
+FrameGraph::FrameGraph()
+: m_compiled(false)
+, m_texturePool(TexturePool::create())
+, m_framebuffers(FramebufferCache::create())
+, m_transientBytes(0)
+, m_releasedBarriers(0u)
+, m_textureBarrierSupported(hasExtension(GLextension::GL_ARB_texture_barrier))
+, m_statistics{ 0, 0, 0, 0, 0, 0 }
+{
+}
+
+FrameGraph::~FrameGraph()
+{
+    clear();
+}
+
+FrameGraph::Resource FrameGraph::importTexture(const std::string & name, Texture * texture)
+{
+    assert(texture != nullptr);
+
+    const Resource resource = addResource(name, true, true);
+    m_resources[resource].texture = texture;
+
+    return resource;
+}
+
+FrameGraph::Resource FrameGraph::importBuffer(const std::string & name, Buffer * buffer)
+{
+    assert(buffer != nullptr);
+
+    const Resource resource = addResource(name, false, true);
+    m_resources[resource].buffer = buffer;
+
+    return resource;
+}
+
+FrameGraph::Resource FrameGraph::addResource(const std::string & name, const bool isTexture, const bool imported)
+{
+    ResourceNode resource;
+    resource.name = name;
+    resource.isTexture = isTexture;
+    resource.imported = imported;
+    resource.size = 0;
+    resource.texture = nullptr;
+    resource.buffer = nullptr;
+    resource.firstUse = s_unused;
+    resource.lastUse = s_unused;
+    resource.pendingBarriers = 0u;
+
+    m_resources.push_back(resource);
+    m_compiled = false;
+
+    return m_resources.size() - 1;
+}
+
+void FrameGraph::addPass(const std::string & name, const Setup & setup, const Execute & execute)
+{
+    PassNode pass;
+    pass.name = name;
+    pass.execute = execute;
+    pass.sideEffect = false;
+    pass.culled = false;
+
+    m_passes.push_back(pass);
+    m_compiled = false;
+
+    PassBuilder builder(*this, m_passes.size() - 1);
+    setup(builder);
+}
+
+void FrameGraph::compile()
+{
+    cull();
+    order();
+    computeLifetimes();
+
+    m_statistics.passes = m_order.size();
+    m_statistics.culledPasses = m_passes.size() - m_order.size();
+
+    m_compiled = true;
+}
+
+void FrameGraph::cull()
+{
+    // a pass is needed if a needed pass reads one of its results (conservatively, any
+    // earlier write of a resource read later is kept, partial writes are common)
+    std::vector<bool> needed(m_resources.size(), false);
+
+    for (std::size_t i = m_passes.size(); i-- > 0;)
+    {
+        PassNode & pass = m_passes[i];
+
+        bool keep = pass.sideEffect;
+
+        for (const Use & use : pass.uses)
+        {
+            keep |= use.write && (m_resources[use.resource].imported || needed[use.resource]);
+        }
+
+        pass.culled = !keep;
+
+        if (!keep)
+        {
+            continue;
+        }
+
+        for (const Use & use : pass.uses)
+        {
+            if (!use.write)
+            {
+                needed[use.resource] = true;
+            }
+        }
+    }
+}
+
+void FrameGraph::order()
+{
+    const std::size_t count = m_passes.size();
+
+    std::vector<std::vector<std::size_t>> successors(count);
+    std::vector<std::size_t> predecessors(count, 0);
+
+    const auto addEdge = [&successors, &predecessors](const std::size_t from, const std::size_t to) {
+        if (from == s_unused || from == to)
+        {
+            return;
+        }
+
+        successors[from].push_back(to);
+        ++predecessors[to];
+    };
+
+    std::vector<std::size_t> lastWriter(m_resources.size(), s_unused);
+    std::vector<std::vector<std::size_t>> readers(m_resources.size());
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const PassNode & pass = m_passes[i];
+
+        if (pass.culled)
+        {
+            continue;
+        }
+
+        for (const Use & use : pass.uses)
+        {
+            // read after write and write after write
+            addEdge(lastWriter[use.resource], i);
+
+            if (use.write)
+            {
+                // write after read
+                for (const std::size_t reader : readers[use.resource])
+                {
+                    addEdge(reader, i);
+                }
+            }
+        }
+
+        for (const Use & use : pass.uses)
+        {
+            if (!use.write)
+            {
+                readers[use.resource].push_back(i);
+            }
+        }
+
+        for (const Use & use : pass.uses)
+        {
+            if (use.write)
+            {
+                lastWriter[use.resource] = i;
+                readers[use.resource].clear();
+            }
+        }
+    }
+
+    std::vector<std::size_t> ready;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (!m_passes[i].culled && predecessors[i] == 0)
+        {
+            ready.push_back(i);
+        }
+    }
+
+    m_order.clear();
+
+    while (!ready.empty())
+    {
+        // the lowest pass index keeps the declared order, unless a ready pass renders
+        // to the same attachments as the previous one and saves a framebuffer switch
+        auto next = std::min_element(ready.begin(), ready.end());
+
+        if (!m_order.empty() && !m_passes[m_order.back()].attachments.empty())
+        {
+            const auto & attachments = m_passes[m_order.back()].attachments;
+
+            const auto same = std::find_if(ready.begin(), ready.end(), [this, &attachments](const std::size_t candidate) {
+                return m_passes[candidate].attachments == attachments; });
+
+            if (same != ready.end())
+            {
+                next = same;
+            }
+        }
+
+        const std::size_t pass = *next;
+        ready.erase(next);
+
+        m_order.push_back(pass);
+
+        for (const std::size_t successor : successors[pass])
+        {
+            if (--predecessors[successor] == 0)
+            {
+                ready.push_back(successor);
+            }
+        }
+    }
+}
+
+void FrameGraph::computeLifetimes()
+{
+    for (ResourceNode & resource : m_resources)
+    {
+        resource.firstUse = s_unused;
+        resource.lastUse = s_unused;
+    }
+
+    for (std::size_t position = 0; position < m_order.size(); ++position)
+    {
+        for (const Use & use : m_passes[m_order[position]].uses)
+        {
+            ResourceNode & resource = m_resources[use.resource];
+
+            if (resource.firstUse == s_unused)
+            {
+                resource.firstUse = position;
+            }
+
+            resource.lastUse = position;
+        }
+    }
+
+    m_acquires.assign(m_order.size(), std::vector<Resource>());
+    m_releases.assign(m_order.size(), std::vector<Resource>());
+
+    for (Resource i = 0; i < m_resources.size(); ++i)
+    {
+        const ResourceNode & resource = m_resources[i];
+
+        if (resource.imported || resource.firstUse == s_unused)
+        {
+            continue;
+        }
+
+        m_acquires[resource.firstUse].push_back(i);
+        m_releases[resource.lastUse].push_back(i);
+    }
+}
+
+void FrameGraph::execute()
+{
+    if (!m_compiled)
+    {
+        compile();
+    }
+
+    m_statistics.transientResources = 0;
+    m_statistics.framebufferSwitches = 0;
+    m_statistics.barriers = 0;
+    m_statistics.peakTransientBytes = 0;
+
+    const unsigned int allBits = allBarrierBits();
+
+    Framebuffer * bound = nullptr;
+    std::vector<FramebufferCache::Attachment> attachments;
+
+    for (std::size_t position = 0; position < m_order.size(); ++position)
+    {
+        PassNode & pass = m_passes[m_order[position]];
+
+        for (const Resource resource : m_acquires[position])
+        {
+            allocate(m_resources[resource]);
+        }
+
+        const unsigned int barriers = barriersFor(pass);
+
+        if (barriers != 0u)
+        {
+            glMemoryBarrier(static_cast<MemoryBarrierMask>(barriers));
+            ++m_statistics.barriers;
+
+            // memory barriers are global
+            for (ResourceNode & resource : m_resources)
+            {
+                resource.pendingBarriers &= ~barriers;
+            }
+
+            m_releasedBarriers &= ~barriers;
+        }
+
+        Framebuffer * framebuffer = nullptr;
+
+        if (!pass.attachments.empty())
+        {
+            attachments.clear();
+
+            for (const AttachmentUse & attachment : pass.attachments)
+            {
+                attachments.emplace_back(attachment.attachment, m_resources[attachment.resource].texture, attachment.level, attachment.layer);
+            }
+
+            framebuffer = m_framebuffers->get(attachments);
+
+            if (framebuffer != bound)
+            {
+                framebuffer->bind();
+                ++m_statistics.framebufferSwitches;
+            }
+
+            if (m_textureBarrierSupported && needsTextureBarrier(pass))
+            {
+                glTextureBarrier();
+            }
+        }
+
+        // passes without attachments may bind other framebuffers, e.g., the default one
+        bound = framebuffer;
+
+        pass.execute(PassContext(*this, framebuffer));
+
+        for (const Use & use : pass.uses)
+        {
+            if (use.write && isIncoherent(use.access))
+            {
+                m_resources[use.resource].pendingBarriers = allBits;
+            }
+        }
+
+        for (const Resource resource : m_releases[position])
+        {
+            release(m_resources[resource]);
+        }
+    }
+}
+
+unsigned int FrameGraph::barriersFor(const PassNode & pass) const
+{
+    unsigned int barriers = 0u;
+
+    for (const Use & use : pass.uses)
+    {
+        barriers |= m_resources[use.resource].pendingBarriers & barrierBits(use.access);
+    }
+
+    return barriers;
+}
+
+bool FrameGraph::needsTextureBarrier(const PassNode & pass) const
+{
+    for (const Use & use : pass.uses)
+    {
+        if (use.access != Access::Sampled)
+        {
+            continue;
+        }
+
+        for (const AttachmentUse & attachment : pass.attachments)
+        {
+            if (attachment.resource == use.resource)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void FrameGraph::allocate(ResourceNode & resource)
+{
+    if (resource.isTexture)
+    {
+        resource.texture = m_texturePool->obtainTexture(resource.description);
+    }
+    else
+    {
+        // best fit among the idle buffers, or a new one
+        PooledBuffer * fit = nullptr;
+
+        for (PooledBuffer & pooled : m_buffers)
+        {
+            if (!pooled.inUse && pooled.size >= resource.size && (!fit || pooled.size < fit->size))
+            {
+                fit = &pooled;
+            }
+        }
+
+        if (!fit)
+        {
+            PooledBuffer pooled;
+            pooled.buffer = Buffer::create();
+            pooled.buffer->setData(resource.size, nullptr, GL_DYNAMIC_COPY);
+            pooled.size = resource.size;
+            pooled.inUse = false;
+
+            m_buffers.push_back(std::move(pooled));
+            fit = &m_buffers.back();
+        }
+
+        fit->inUse = true;
+        resource.buffer = fit->buffer.get();
+    }
+
+    // the object may still be written incoherently as a previous resource
+    resource.pendingBarriers = m_releasedBarriers;
+
+    ++m_statistics.transientResources;
+
+    m_transientBytes += sizeInBytes(resource);
+    m_statistics.peakTransientBytes = std::max(m_statistics.peakTransientBytes, m_transientBytes);
+}
+
+void FrameGraph::release(ResourceNode & resource)
+{
+    m_releasedBarriers |= resource.pendingBarriers;
+
+    if (resource.texture)
+    {
+        m_texturePool->release(resource.texture);
+        resource.texture = nullptr;
+    }
+    else if (resource.buffer)
+    {
+        for (PooledBuffer & pooled : m_buffers)
+        {
+            if (pooled.buffer.get() == resource.buffer)
+            {
+                pooled.inUse = false;
+            }
+        }
+
+        resource.buffer = nullptr;
+    }
+    else
+    {
+        return;
+    }
+
+    m_transientBytes -= sizeInBytes(resource);
+}
+
+void FrameGraph::clear()
+{
+    // transient resources still held if execute() did not complete
+    for (ResourceNode & resource : m_resources)
+    {
+        if (!resource.imported)
+        {
+            release(resource);
+        }
+    }
+
+    m_resources.clear();
+    m_passes.clear();
+    m_order.clear();
+    m_acquires.clear();
+    m_releases.clear();
+
+    m_compiled = false;
+}
+
+std::vector<std::string> FrameGraph::executionOrder() const
+{
+    std::vector<std::string> names;
+
+    for (const std::size_t pass : m_order)
+    {
+        names.push_back(m_passes[pass].name);
+    }
+
+    return names;
+}
+
+TexturePool * FrameGraph::texturePool() const
+{
+    return m_texturePool.get();
+}
+
+const FrameGraph::Statistics & FrameGraph::statistics() const
+{
+    return m_statistics;
+}
+
+std::size_t FrameGraph::sizeInBytes(const ResourceNode & resource)
+{
+    return resource.isTexture ? TexturePool::sizeInBytes(resource.description) : static_cast<std::size_t>(resource.size);
+}
+
+
+} // namespace globjects
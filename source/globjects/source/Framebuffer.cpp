@@ -15,6 +15,7 @@
 #include <globjects/AttachedRenderbuffer.h>
 #include "pixelformat.h"
 
+#include "registry/BarrierTracker.h"
 #include "registry/ImplementationRegistry.h"
 #include "registry/ObjectRegistry.h"
 
@@ -214,6 +215,16 @@ void Framebuffer::clearBuffer(const GLenum buffer, const GLfloat depth, const GL
     implementation().clearBufferfi(this, buffer, drawBuffer, depth, stencil);
 }
 
+void Framebuffer::invalidate(const std::vector<GLenum> & attachments)
+{
+    implementation().invalidate(this, static_cast<GLsizei>(attachments.size()), attachments.data());
+}
+
+void Framebuffer::invalidateSubData(const std::vector<GLenum> & attachments, const std::array<GLint, 4> & rect)
+{
+    implementation().invalidateSubData(this, static_cast<GLsizei>(attachments.size()), attachments.data(), rect[0], rect[1], rect[2], rect[3]);
+}
+
 void Framebuffer::clearBuffer(const GLenum buffer, const GLint drawBuffer, const glm::ivec4 & value)
 {
     clearBuffer(buffer, drawBuffer, glm::value_ptr(value));
@@ -276,6 +287,8 @@ void Framebuffer::clearDepth(const GLdouble depth)
 
 void Framebuffer::readPixels(const GLint x, const GLint y, const GLsizei width, const GLsizei height, const GLenum format, const GLenum type, GLvoid * data) const
 {
+    BarrierTracker::current().pixelTransfer();
+
     implementation().readPixels(this, x, y, width, height, format, type, data);
 }
 
@@ -0,0 +1,243 @@
+
+#include <globjects/FramebufferCache.h>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <utility>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Framebuffer.h>
+#include <globjects/Texture.h>
+#include <globjects/logging.h>
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+bool isColorAttachment(const GLenum attachment)
+{
+    return static_cast<unsigned int>(attachment) >= static_cast<unsigned int>(GL_COLOR_ATTACHMENT0)
+        && static_cast<unsigned int>(attachment) <= static_cast<unsigned int>(GL_COLOR_ATTACHMENT31);
+}
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+FramebufferCache::Attachment::Attachment()
+: Attachment(GL_COLOR_ATTACHMENT0, nullptr)
+{
+}
+
+FramebufferCache::Attachment::Attachment(const GLenum attachment, Texture * texture, const GLint level, const GLint layer)
+: attachment(attachment)
+, texture(texture)
+, level(level)
+, layer(layer)
+{
+}
+
+bool FramebufferCache::Attachment::operator==(const Attachment & other) const
+{
+    return attachment == other.attachment && texture == other.texture && level == other.level && layer == other.layer;
+}
+
+bool FramebufferCache::Attachment::operator<(const Attachment & other) const
+{
+    return attachment < other.attachment;
+}
+
+std::size_t FramebufferCache::KeyHash::operator()(const Key & key) const
+{
+    std::size_t hash = 0;
+
+    for (const auto & attachment : key)
+    {
+        for (const std::size_t value : { std::hash<unsigned int>()(static_cast<unsigned int>(attachment.attachment)),
+            std::hash<const Texture *>()(attachment.texture), std::hash<GLint>()(attachment.level), std::hash<GLint>()(attachment.layer) })
+        {
+            hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+    }
+
+    return hash;
+}
+
+FramebufferCache::FramebufferCache()
+{
+}
+
+FramebufferCache::~FramebufferCache()
+{
+    clear();
+}
+
+Framebuffer * FramebufferCache::get(const std::vector<Attachment> & attachments)
+{
+    Key key = attachments;
+    std::sort(key.begin(), key.end());
+
+    assert(std::adjacent_find(key.begin(), key.end(), [](const Attachment & a, const Attachment & b) {
+        return a.attachment == b.attachment; }) == key.end());
+
+    const auto it = m_entries.find(key);
+
+    if (it != m_entries.end())
+    {
+        return it->second.framebuffer.get();
+    }
+
+    Entry entry;
+    entry.framebuffer = Framebuffer::create();
+
+    for (const auto & attachment : key)
+    {
+        assert(attachment.texture != nullptr);
+
+        if (attachment.layer < 0)
+        {
+            entry.framebuffer->attachTexture(attachment.attachment, attachment.texture, attachment.level);
+        }
+        else
+        {
+            entry.framebuffer->attachTextureLayer(attachment.attachment, attachment.texture, attachment.level, attachment.layer);
+        }
+
+        if (isColorAttachment(attachment.attachment))
+        {
+            entry.drawBuffers.push_back(attachment.attachment);
+        }
+
+        reference(attachment.texture);
+    }
+
+    if (entry.drawBuffers.empty())
+    {
+        entry.drawBuffers.push_back(GL_NONE);
+    }
+
+    entry.framebuffer->setDrawBuffers(entry.drawBuffers);
+
+    entry.status = entry.framebuffer->checkStatus();
+
+    if (entry.status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        critical() << "FramebufferCache: incomplete framebuffer, " << entry.framebuffer->statusString();
+    }
+
+    Framebuffer * framebuffer = entry.framebuffer.get();
+
+    // references to unordered_map elements stay valid on rehashing
+    Entry & inserted = m_entries.emplace(std::move(key), std::move(entry)).first->second;
+    m_framebuffers[framebuffer] = &inserted;
+
+    return framebuffer;
+}
+
+void FramebufferCache::setDrawBuffers(Framebuffer * framebuffer, const std::vector<GLenum> & modes)
+{
+    Entry & e = entry(framebuffer);
+
+    if (e.drawBuffers == modes)
+    {
+        return;
+    }
+
+    framebuffer->setDrawBuffers(modes);
+    e.drawBuffers = modes;
+}
+
+GLenum FramebufferCache::status(const Framebuffer * framebuffer) const
+{
+    const auto it = m_framebuffers.find(framebuffer);
+
+    assert(it != m_framebuffers.end());
+
+    return it->second->status;
+}
+
+void FramebufferCache::evict(const Texture * texture)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        const Key & key = it->first;
+
+        const bool references = std::any_of(key.begin(), key.end(), [texture](const Attachment & attachment) {
+            return attachment.texture == texture; });
+
+        if (!references)
+        {
+            ++it;
+            continue;
+        }
+
+        // deregisters from texture with its last reference
+        for (const auto & attachment : key)
+        {
+            dereference(attachment.texture);
+        }
+
+        m_framebuffers.erase(it->second.framebuffer.get());
+        it = m_entries.erase(it);
+    }
+}
+
+void FramebufferCache::clear()
+{
+    for (const auto & pair : m_references)
+    {
+        pair.first->deregisterListener(this);
+    }
+
+    m_references.clear();
+    m_framebuffers.clear();
+    m_entries.clear();
+}
+
+std::size_t FramebufferCache::size() const
+{
+    return m_entries.size();
+}
+
+void FramebufferCache::reference(Texture * texture)
+{
+    if (m_references[texture]++ == 0)
+    {
+        texture->registerListener(this);
+    }
+}
+
+void FramebufferCache::dereference(Texture * texture)
+{
+    const auto it = m_references.find(texture);
+
+    assert(it != m_references.end());
+
+    if (--it->second == 0)
+    {
+        texture->deregisterListener(this);
+        m_references.erase(it);
+    }
+}
+
+FramebufferCache::Entry & FramebufferCache::entry(const Framebuffer * framebuffer)
+{
+    const auto it = m_framebuffers.find(framebuffer);
+
+    assert(it != m_framebuffers.end());
+
+    return *it->second;
+}
+
+
+} // namespace globjects
@@ -0,0 +1,217 @@
+
+#include <globjects/Histogram.h>
+
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/Program.h>
+#include <globjects/Texture.h>
+
+#include "ComputeKernel.h"
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+const char * const histogramSource = R"(
+layout (local_size_x = 256) in;
+
+#if defined(SOURCE_BUFFER)
+layout (std430, binding = 0) readonly buffer Input { float inputs[]; };
+#else
+uniform sampler2D source;
+uniform int level;
+uniform int component;
+#endif
+
+layout (std430, binding = 1) buffer Bins { uint bins[]; };
+
+uniform uint count;
+uniform float minimum;
+uniform float maximum;
+
+shared uint localBins[BIN_COUNT];
+
+float load(uint index)
+{
+#if defined(SOURCE_BUFFER)
+    return inputs[index];
+#else
+    ivec2 size = textureSize(source, level);
+    vec4 texel = texelFetch(source, ivec2(int(index) % size.x, int(index) / size.x), level);
+
+    return component < 0 ? dot(texel.rgb, vec3(0.2126, 0.7152, 0.0722)) : texel[component];
+#endif
+}
+
+void main()
+{
+    uint group = groupIndex();
+    uint local = gl_LocalInvocationID.x;
+
+    if (group * 1024u >= count)
+        return;
+
+    for (uint i = local; i < BIN_COUNT; i += 256u)
+        localBins[i] = 0u;
+
+    barrier();
+
+    float scale = float(BIN_COUNT) / (maximum - minimum);
+
+    for (uint i = 0u; i < 4u; ++i)
+    {
+        uint index = group * 1024u + i * 256u + local;
+
+        if (index < count)
+        {
+            float bin = clamp((load(index) - minimum) * scale, 0.0, float(BIN_COUNT - 1u));
+            atomicAdd(localBins[uint(bin)], 1u);
+        }
+    }
+
+    barrier();
+
+    for (uint i = local; i < BIN_COUNT; i += 256u)
+    {
+        if (localBins[i] != 0u)
+            atomicAdd(bins[i], localBins[i]);
+    }
+}
+)";
+
+
+GLuint tileCount(const GLuint count)
+{
+    return (count + globjects::Histogram::s_tileSize - 1) / globjects::Histogram::s_tileSize;
+}
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+Histogram::Histogram(const GLuint binCount)
+: m_binCount(binCount)
+, m_minimum(0.0f)
+, m_maximum(1.0f)
+, m_buffer(new ComputeKernel("#define SOURCE_BUFFER\n#define BIN_COUNT " + std::to_string(binCount) + "u\n", histogramSource))
+, m_texture(new ComputeKernel("#define SOURCE_TEXTURE\n#define BIN_COUNT " + std::to_string(binCount) + "u\n", histogramSource))
+, m_bins(Buffer::create())
+{
+    assert(binCount > 0 && binCount <= s_maxBinCount);
+
+    m_bins->setData(static_cast<GLsizeiptr>(binCount) * static_cast<GLsizeiptr>(sizeof(GLuint)), nullptr, GL_DYNAMIC_COPY);
+}
+
+Histogram::~Histogram()
+{
+}
+
+GLuint Histogram::binCount() const
+{
+    return m_binCount;
+}
+
+void Histogram::setRange(const float minimum, const float maximum)
+{
+    assert(minimum < maximum);
+
+    m_minimum = minimum;
+    m_maximum = maximum;
+}
+
+float Histogram::minimum() const
+{
+    return m_minimum;
+}
+
+float Histogram::maximum() const
+{
+    return m_maximum;
+}
+
+void Histogram::compute(const Buffer * input, const GLuint count)
+{
+    assert(input != nullptr);
+
+    input->bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+
+    prepare(*m_buffer, count);
+
+    m_buffer->dispatch(tileCount(count));
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_UNIFORM_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+void Histogram::compute(const Texture * texture, const GLint level, const GLint component)
+{
+    assert(texture != nullptr);
+    assert(component >= s_luminance && component < 4);
+
+    const GLint width = texture->getLevelParameter(level, GL_TEXTURE_WIDTH);
+    const GLint height = texture->getLevelParameter(level, GL_TEXTURE_HEIGHT);
+    const GLuint count = static_cast<GLuint>(width * height);
+
+    texture->bindActive(0u);
+
+    Program * program = m_texture->program();
+    program->setUniform("source", 0);
+    program->setUniform("level", level);
+    program->setUniform("component", component);
+
+    prepare(*m_texture, count);
+
+    m_texture->dispatch(tileCount(count));
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_UNIFORM_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+void Histogram::prepare(const ComputeKernel & kernel, const GLuint count)
+{
+    m_bins->clearData(GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT);
+    m_bins->bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+
+    Program * program = kernel.program();
+    program->setUniform("count", count);
+    program->setUniform("minimum", m_minimum);
+    program->setUniform("maximum", m_maximum);
+}
+
+Buffer * Histogram::bins() const
+{
+    return m_bins.get();
+}
+
+AsyncResult<std::vector<GLuint>> Histogram::binsAsync() const
+{
+    AsyncResult<std::vector<GLuint>> result;
+
+    const GLuint binCount = m_binCount;
+
+    m_bins->readAsync(0, static_cast<GLsizeiptr>(binCount) * static_cast<GLsizeiptr>(sizeof(GLuint))).then([result, binCount](const std::vector<unsigned char> & data) {
+        std::vector<GLuint> bins(binCount);
+        std::memcpy(bins.data(), data.data(), bins.size() * sizeof(GLuint));
+
+        result.resolve(std::move(bins));
+    });
+
+    return result;
+}
+
+
+} // namespace globjects
@@ -0,0 +1,234 @@
+
+#include <globjects/IndirectCommandBuffer.h>
+
+#include <cassert>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/values.h>
+#include <glbinding/gl/extension.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+#include <globjects/Sync.h>
+#include <globjects/VertexArray.h>
+
+
+using namespace gl;
+
+
+namespace globjects
+{
+
+
+IndirectCommandBuffer::IndirectCommandBuffer(const GLsizei capacity, const GLsizei regionCount)
+: m_buffer(Buffer::create())
+, m_capacity(capacity)
+, m_regionSize(static_cast<GLsizeiptr>(capacity) * static_cast<GLsizeiptr>(sizeof(DrawElementsCommand)))
+, m_mapped(nullptr)
+, m_regions(static_cast<std::size_t>(regionCount))
+, m_region(0)
+, m_kind(Kind::None)
+, m_size(0)
+, m_uploaded(0)
+{
+    assert(capacity > 0);
+    assert(regionCount > 0);
+
+    const GLsizeiptr size = m_regionSize * regionCount;
+
+    if (hasExtension(GLextension::GL_ARB_buffer_storage))
+    {
+        m_buffer->setStorage(size, nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+        m_mapped = static_cast<unsigned char *>(m_buffer->mapRange(0, size, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
+    }
+
+    if (m_mapped == nullptr)
+    {
+        m_buffer->setData(size, nullptr, GL_STREAM_DRAW);
+        m_staging.resize(static_cast<std::size_t>(m_regionSize));
+    }
+
+    for (auto & region : m_regions)
+    {
+        region.pending = false;
+    }
+}
+
+IndirectCommandBuffer::~IndirectCommandBuffer()
+{
+    if (m_mapped)
+    {
+        m_buffer->unmap();
+    }
+}
+
+void IndirectCommandBuffer::begin()
+{
+    m_region = (m_region + 1) % m_regions.size();
+
+    Region & region = m_regions[m_region];
+
+    // the draws that last read this region have to finish before it is overwritten
+    if (region.pending)
+    {
+        region.fence->clientWait(GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        region.pending = false;
+    }
+
+    m_kind = Kind::None;
+    m_size = 0;
+    m_uploaded = 0;
+}
+
+bool IndirectCommandBuffer::add(const DrawArraysCommand & command)
+{
+    void * target = append(Kind::Arrays, sizeof(DrawArraysCommand));
+
+    if (target == nullptr)
+    {
+        return false;
+    }
+
+    *static_cast<DrawArraysCommand *>(target) = command;
+
+    return true;
+}
+
+bool IndirectCommandBuffer::add(const DrawElementsCommand & command)
+{
+    void * target = append(Kind::Elements, sizeof(DrawElementsCommand));
+
+    if (target == nullptr)
+    {
+        return false;
+    }
+
+    *static_cast<DrawElementsCommand *>(target) = command;
+
+    return true;
+}
+
+bool IndirectCommandBuffer::addArrays(const GLuint count, const GLuint instanceCount, const GLuint first, const GLuint baseInstance)
+{
+    return add(DrawArraysCommand{ count, instanceCount, first, baseInstance });
+}
+
+bool IndirectCommandBuffer::addElements(const GLuint count, const GLuint instanceCount, const GLuint firstIndex, const GLint baseVertex, const GLuint baseInstance)
+{
+    return add(DrawElementsCommand{ count, instanceCount, firstIndex, baseVertex, baseInstance });
+}
+
+void IndirectCommandBuffer::drawArrays(const VertexArray * vertexArray, const GLenum mode)
+{
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    const GLintptr offset = prepareDraw(Kind::Arrays);
+
+    vertexArray->multiDrawArraysIndirect(mode, reinterpret_cast<const void *>(offset), m_size, 0);
+
+    fence();
+}
+
+void IndirectCommandBuffer::drawElements(const VertexArray * vertexArray, const GLenum mode, const GLenum type)
+{
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    const GLintptr offset = prepareDraw(Kind::Elements);
+
+    vertexArray->multiDrawElementsIndirect(mode, type, reinterpret_cast<const void *>(offset), m_size, 0);
+
+    fence();
+}
+
+GLsizei IndirectCommandBuffer::size() const
+{
+    return m_size;
+}
+
+GLsizei IndirectCommandBuffer::capacity() const
+{
+    return m_capacity;
+}
+
+bool IndirectCommandBuffer::isPersistentlyMapped() const
+{
+    return m_mapped != nullptr;
+}
+
+Buffer * IndirectCommandBuffer::buffer() const
+{
+    return m_buffer.get();
+}
+
+void * IndirectCommandBuffer::append(const Kind kind, const GLsizeiptr size)
+{
+    assert(m_kind == Kind::None || m_kind == kind);
+
+    // the region and the staging array end after capacity commands
+    if (m_size >= m_capacity)
+    {
+        return nullptr;
+    }
+
+    m_kind = kind;
+
+    const GLsizeiptr offset = m_size * size;
+
+    ++m_size;
+
+    if (m_mapped)
+    {
+        return m_mapped + static_cast<GLsizeiptr>(m_region) * m_regionSize + offset;
+    }
+
+    return m_staging.data() + offset;
+}
+
+GLintptr IndirectCommandBuffer::prepareDraw(const Kind kind)
+{
+    assert(m_kind == kind);
+
+    const GLintptr offset = static_cast<GLintptr>(m_region) * m_regionSize;
+
+    if (!m_mapped)
+    {
+        // upload only the commands added since the last draw of this batch
+        const GLsizeiptr size = m_size * static_cast<GLsizeiptr>(kind == Kind::Arrays ? sizeof(DrawArraysCommand) : sizeof(DrawElementsCommand));
+
+        if (size > m_uploaded)
+        {
+            m_buffer->setSubData(offset + m_uploaded, size - m_uploaded, m_staging.data() + m_uploaded);
+            m_uploaded = size;
+        }
+    }
+
+    m_buffer->bind(GL_DRAW_INDIRECT_BUFFER);
+
+    return offset;
+}
+
+void IndirectCommandBuffer::fence()
+{
+    Region & region = m_regions[m_region];
+
+    if (region.fence)
+    {
+        region.fence->renew(GL_SYNC_GPU_COMMANDS_COMPLETE);
+    }
+    else
+    {
+        region.fence = Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE);
+    }
+
+    region.pending = true;
+}
+
+
+} // namespace globjects
@@ -0,0 +1,234 @@
+
+#include <globjects/InstanceBatcher.h>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/Program.h>
+#include <globjects/VertexArray.h>
+#include <globjects/VertexAttributeBinding.h>
+
+
+using namespace gl;
+
+
+namespace globjects
+{
+
+
+InstanceBatcher::Mesh::Mesh(const VertexArray * vertexArray, const GLenum mode, const GLint first, const GLsizei count)
+: vertexArray(vertexArray)
+, mode(mode)
+, type(GL_NONE)
+, first(first)
+, count(count)
+, indices(nullptr)
+, baseVertex(0)
+{
+}
+
+InstanceBatcher::Mesh::Mesh(const VertexArray * vertexArray, const GLenum mode, const GLsizei count, const GLenum type, const void * indices, const GLint baseVertex)
+: vertexArray(vertexArray)
+, mode(mode)
+, type(type)
+, first(0)
+, count(count)
+, indices(indices)
+, baseVertex(baseVertex)
+{
+}
+
+std::size_t InstanceBatcher::KeyHash::operator()(const std::pair<const Mesh *, const Program *> & key) const
+{
+    const std::size_t mesh = std::hash<const Mesh *>()(key.first);
+
+    return mesh ^ (std::hash<const Program *>()(key.second) + 0x9e3779b9 + (mesh << 6) + (mesh >> 2));
+}
+
+InstanceBatcher::InstanceBatcher(const GLsizei instanceSize, const Mode mode, const GLuint storageIndex)
+: m_instanceSize(instanceSize)
+, m_mode(mode)
+, m_storageIndex(storageIndex)
+, m_buffer(Buffer::create())
+, m_capacity(0)
+, m_instanceCount(0)
+{
+    assert(instanceSize > 0);
+}
+
+InstanceBatcher::~InstanceBatcher()
+{
+}
+
+void InstanceBatcher::bindInstanceBuffer(VertexAttributeBinding * binding) const
+{
+    assert(m_mode == Mode::VertexAttributes);
+
+    // orphaning keeps the buffer's name, so the binding stays valid across frames
+    binding->setBuffer(m_buffer.get(), 0, m_instanceSize);
+    binding->setDivisor(1);
+}
+
+void InstanceBatcher::setGroupCallback(GroupCallback callback)
+{
+    m_groupCallback = std::move(callback);
+}
+
+void InstanceBatcher::submit(const Mesh * mesh, Program * program, const GLsizei size, const void * instanceData)
+{
+    assert(mesh != nullptr);
+    assert(program != nullptr);
+    assert(size == m_instanceSize);
+
+    const auto inserted = m_groupIndices.emplace(std::make_pair(mesh, static_cast<const Program *>(program)), m_groups.size());
+
+    if (inserted.second)
+    {
+        m_groups.push_back({ mesh, program, std::vector<unsigned char>() });
+    }
+
+    auto & data = m_groups[inserted.first->second].data;
+    const auto bytes = static_cast<const unsigned char *>(instanceData);
+
+    data.insert(data.end(), bytes, bytes + size);
+
+    ++m_instanceCount;
+}
+
+void InstanceBatcher::execute()
+{
+    if (m_instanceCount == 0)
+    {
+        return;
+    }
+
+    const GLsizeiptr size = static_cast<GLsizeiptr>(m_instanceCount) * m_instanceSize;
+
+    // orphan the previous frame's storage instead of waiting for its draws
+    if (size > m_capacity)
+    {
+        m_capacity = std::max(size, m_capacity * 2);
+    }
+
+    m_buffer->setData(m_capacity, nullptr, GL_STREAM_DRAW);
+
+    GLsizeiptr offset = 0;
+
+    for (const auto & group : m_groups)
+    {
+        if (group.data.empty())
+        {
+            continue;
+        }
+
+        const auto groupSize = static_cast<GLsizeiptr>(group.data.size());
+
+        m_buffer->setSubData(offset, groupSize, group.data.data());
+        offset += groupSize;
+    }
+
+    if (m_mode == Mode::ShaderStorage)
+    {
+        m_buffer->bindBase(GL_SHADER_STORAGE_BUFFER, m_storageIndex);
+    }
+
+    const Program * current = nullptr;
+    GLuint baseInstance = 0;
+
+    for (const auto & group : m_groups)
+    {
+        if (group.data.empty())
+        {
+            continue;
+        }
+
+        if (group.program != current)
+        {
+            group.program->use();
+            current = group.program;
+        }
+
+        if (m_groupCallback)
+        {
+            m_groupCallback(*group.mesh, group.program);
+        }
+
+        draw(group, baseInstance);
+
+        baseInstance += static_cast<GLuint>(group.data.size() / static_cast<std::size_t>(m_instanceSize));
+    }
+}
+
+void InstanceBatcher::clear()
+{
+    std::size_t kept = 0;
+
+    for (std::size_t i = 0; i < m_groups.size(); ++i)
+    {
+        Group & group = m_groups[i];
+        const auto key = std::make_pair(group.mesh, static_cast<const Program *>(group.program));
+
+        // unused for a whole frame, its mesh may be gone
+        if (group.data.empty())
+        {
+            m_groupIndices.erase(key);
+
+            continue;
+        }
+
+        group.data.clear();
+
+        if (kept != i)
+        {
+            m_groups[kept] = std::move(group);
+            m_groupIndices[key] = kept;
+        }
+
+        ++kept;
+    }
+
+    m_groups.erase(m_groups.begin() + static_cast<std::ptrdiff_t>(kept), m_groups.end());
+
+    m_instanceCount = 0;
+}
+
+std::size_t InstanceBatcher::instanceCount() const
+{
+    return m_instanceCount;
+}
+
+std::size_t InstanceBatcher::groupCount() const
+{
+    return m_groups.size();
+}
+
+Buffer * InstanceBatcher::instanceBuffer() const
+{
+    return m_buffer.get();
+}
+
+void InstanceBatcher::draw(const Group & group, const GLuint baseInstance) const
+{
+    const Mesh & mesh = *group.mesh;
+    const auto instanceCount = static_cast<GLsizei>(group.data.size() / static_cast<std::size_t>(m_instanceSize));
+
+    if (mesh.type == GL_NONE)
+    {
+        mesh.vertexArray->drawArraysInstancedBaseInstance(mesh.mode, mesh.first, mesh.count, instanceCount, baseInstance);
+    }
+    else if (mesh.baseVertex != 0)
+    {
+        mesh.vertexArray->drawElementsInstancedBaseVertexBaseInstance(mesh.mode, mesh.count, mesh.type, mesh.indices, instanceCount, mesh.baseVertex, baseInstance);
+    }
+    else
+    {
+        mesh.vertexArray->drawElementsInstancedBaseInstance(mesh.mode, mesh.count, mesh.type, mesh.indices, instanceCount, baseInstance);
+    }
+}
+
+
+} // namespace globjects
@@ -0,0 +1,318 @@
+
+#include <globjects/MipGenerator.h>
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/boolean.h>
+
+#include <globjects/logging.h>
+#include <globjects/Program.h>
+#include <globjects/Texture.h>
+
+#include "ComputeKernel.h"
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+const GLint tileSize = 16;
+
+
+// writes level 0 from the sampled source, further levels from the tile in shared memory
+const char * const mipSource = R"(
+layout (local_size_x = 16, local_size_y = 16) in;
+
+uniform sampler2D source;
+uniform int sourceLevel;
+uniform int levelCount;
+uniform bool decode;
+uniform bool encode;
+
+layout (binding = 0) writeonly uniform image2D outputs[5];
+
+shared vec4 tile[256];
+
+#if defined(FILTER_MIN)
+#define IDENTITY vec4(uintBitsToFloat(0x7f800000u))
+#define ACCUMULATE(a, b) min(a, b)
+#elif defined(FILTER_MAX)
+#define IDENTITY vec4(uintBitsToFloat(0xff800000u))
+#define ACCUMULATE(a, b) max(a, b)
+#else
+#define AVERAGE
+#define IDENTITY vec4(0.0)
+#define ACCUMULATE(a, b) ((a) + (b))
+#endif
+
+vec3 toLinear(vec3 color)
+{
+    return mix(color / 12.92, pow((color + 0.055) / 1.055, vec3(2.4)), greaterThan(color, vec3(0.04045)));
+}
+
+vec3 toSRGB(vec3 color)
+{
+    return mix(color * 12.92, 1.055 * pow(color, vec3(1.0 / 2.4)) - 0.055, greaterThan(color, vec3(0.0031308)));
+}
+
+vec4 load(ivec2 position, ivec2 size)
+{
+    vec4 texel = texelFetch(source, min(position, size - 1), sourceLevel);
+
+    if (decode)
+        texel.rgb = toLinear(texel.rgb);
+
+    return texel;
+}
+
+void store(int level, ivec2 position, vec4 value)
+{
+    if (any(greaterThanEqual(position, imageSize(outputs[level]))))
+        return;
+
+    if (encode)
+        value.rgb = toSRGB(clamp(value.rgb, 0.0, 1.0));
+
+    imageStore(outputs[level], position, value);
+}
+
+void main()
+{
+    ivec2 local = ivec2(gl_LocalInvocationID.xy);
+    ivec2 position = ivec2(gl_WorkGroupID.xy) * 16 + local;
+
+    ivec2 sourceSize = textureSize(source, sourceLevel);
+    ivec2 size = imageSize(outputs[0]);
+
+    // footprint in the source level, widened to three texels for odd sizes
+    ivec2 lower = position * sourceSize / size;
+    ivec2 upper = min(max(lower + 1, ((position + 1) * sourceSize + size - 1) / size), lower + 3);
+
+    vec4 value = IDENTITY;
+
+    for (int y = lower.y; y < upper.y; ++y)
+    {
+        for (int x = lower.x; x < upper.x; ++x)
+            value = ACCUMULATE(value, load(ivec2(x, y), sourceSize));
+    }
+
+#ifdef AVERAGE
+    value /= float((upper.x - lower.x) * (upper.y - lower.y));
+#endif
+
+    store(0, position, value);
+    tile[local.y * 16 + local.x] = value;
+
+    for (int level = 1; level < levelCount; ++level)
+    {
+        int extent = 16 >> level;
+        bool active = all(lessThan(local, ivec2(extent)));
+
+        vec4 reduced = IDENTITY;
+
+        barrier();
+
+        if (active)
+        {
+            int index = local.y * 32 + local.x * 2;
+
+            reduced = ACCUMULATE(ACCUMULATE(tile[index], tile[index + 1]), ACCUMULATE(tile[index + 16], tile[index + 17]));
+#ifdef AVERAGE
+            reduced *= 0.25;
+#endif
+        }
+
+        barrier();
+
+        if (active)
+        {
+            tile[local.y * 16 + local.x] = reduced;
+            store(level, ivec2(gl_WorkGroupID.xy) * extent + local, reduced);
+        }
+    }
+}
+)";
+
+
+std::string defines(const globjects::MipGenerator::Filter filter)
+{
+    switch (filter)
+    {
+    case globjects::MipGenerator::Filter::Min:
+        return "#define FILTER_MIN\n";
+    case globjects::MipGenerator::Filter::Max:
+        return "#define FILTER_MAX\n";
+    default:
+        return "";
+    }
+}
+
+bool isSRGB(const globjects::Texture * texture)
+{
+    return static_cast<GLenum>(texture->getLevelParameter(0, GL_TEXTURE_INTERNAL_FORMAT)) == GL_SRGB8_ALPHA8;
+}
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+MipGenerator::MipGenerator(const Filter filter)
+: m_filter(filter)
+, m_kernel(new ComputeKernel(defines(filter), mipSource))
+{
+    m_kernel->program()->setUniform("source", 0);
+}
+
+MipGenerator::~MipGenerator()
+{
+}
+
+MipGenerator::Filter MipGenerator::filter() const
+{
+    return m_filter;
+}
+
+void MipGenerator::generate(Texture * texture)
+{
+    generate(texture, 0, levelCount(texture) - 1);
+}
+
+void MipGenerator::generate(Texture * texture, const GLint baseLevel, const GLint levelCount)
+{
+    assert(texture != nullptr);
+
+    if (levelCount < 1)
+    {
+        return;
+    }
+
+    run(texture, baseLevel, texture, baseLevel + 1, baseLevel + levelCount);
+}
+
+void MipGenerator::generate(const Texture * source, Texture * target)
+{
+    assert(source != nullptr);
+    assert(target != nullptr);
+
+    run(source, 0, target, 0, levelCount(target) - 1);
+}
+
+void MipGenerator::run(const Texture * source, const GLint sourceLevel, Texture * target, const GLint firstLevel, const GLint lastLevel)
+{
+    const GLenum format = static_cast<GLenum>(target->getLevelParameter(0, GL_TEXTURE_INTERNAL_FORMAT));
+    const bool srgb = format == GL_SRGB8_ALPHA8;
+
+    // sRGB formats are no image formats; they are written through a GL_RGBA8 view, encoded in the shader
+    std::unique_ptr<Texture> view;
+    Texture * output = target;
+    GLenum imageFormat = format;
+
+    if (srgb)
+    {
+        if (target->getParameter(GL_TEXTURE_IMMUTABLE_FORMAT) == 0)
+        {
+            warning() << "MipGenerator requires immutable storage for GL_SRGB8_ALPHA8 textures";
+
+            return;
+        }
+
+        // a view needs a name that was never bound, which glCreateTextures does not provide
+        GLuint viewId = 0;
+        glGenTextures(1, &viewId);
+        glTextureView(viewId, GL_TEXTURE_2D, target->id(), GL_RGBA8, 0, static_cast<GLuint>(target->getParameter(GL_TEXTURE_IMMUTABLE_LEVELS)), 0, 1);
+
+        view = Texture::fromId(viewId, GL_TEXTURE_2D);
+        output = view.get();
+        imageFormat = GL_RGBA8;
+    }
+
+    const bool srgbData = m_filter == Filter::SRGBAverage;
+
+    Program * program = m_kernel->program();
+    program->setUniform("encode", srgb || srgbData);
+
+    const Texture * input = source;
+    GLint inputLevel = sourceLevel;
+    bool decode = srgbData && !isSRGB(source);
+
+    for (GLint level = firstLevel; level <= lastLevel;)
+    {
+        const GLint width = target->getLevelParameter(level, GL_TEXTURE_WIDTH);
+        const GLint height = target->getLevelParameter(level, GL_TEXTURE_HEIGHT);
+
+        // chain levels as long as the tiles halve evenly
+        GLint count = 1;
+        while (count < s_levelsPerDispatch && level + count <= lastLevel
+            && (width >> (count - 1)) % 2 == 0 && (height >> (count - 1)) % 2 == 0)
+        {
+            ++count;
+        }
+
+        for (GLint i = 0; i < count; ++i)
+        {
+            output->bindImageTexture(static_cast<GLuint>(i), level + i, GL_FALSE, 0, GL_WRITE_ONLY, imageFormat);
+        }
+
+        input->bindActive(0u);
+
+        program->setUniform("sourceLevel", inputLevel);
+        program->setUniform("levelCount", count);
+        program->setUniform("decode", decode);
+
+        program->dispatchCompute(
+            static_cast<GLuint>((width + tileSize - 1) / tileSize),
+            static_cast<GLuint>((height + tileSize - 1) / tileSize), 1);
+
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+        input = target;
+        inputLevel = level + count - 1;
+        decode = srgbData && !srgb;
+        level += count;
+    }
+
+    if (view)
+    {
+        // views from fromId() are not owned
+        const GLuint viewId = view->id();
+        view.reset();
+
+        glDeleteTextures(1, &viewId);
+    }
+}
+
+GLint MipGenerator::levelCount(const Texture * texture)
+{
+    const GLint immutableLevels = texture->getParameter(GL_TEXTURE_IMMUTABLE_LEVELS);
+
+    if (immutableLevels > 0)
+    {
+        return immutableLevels;
+    }
+
+    GLint size = std::max(texture->getLevelParameter(0, GL_TEXTURE_WIDTH), texture->getLevelParameter(0, GL_TEXTURE_HEIGHT));
+
+    GLint levels = 1;
+    while (size > 1)
+    {
+        size /= 2;
+        ++levels;
+    }
+
+    return levels;
+}
+
+
+} // namespace globjects
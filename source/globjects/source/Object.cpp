@@ -36,6 +36,7 @@ void Object::hintNameImplementation(const NameImplementation impl)
 Object::Object(std::unique_ptr<IDResource> && resource)
     : m_resource(std::move(resource))
 , m_objectLabelState(nullptr)
+, m_registryIndex(ObjectRegistry::s_invalidIndex)
 {
     ObjectRegistry::current().registerObject(this);
 }
@@ -0,0 +1,318 @@
+
+#include <globjects/PrefixScan.h>
+
+#include <cassert>
+#include <string>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/Program.h>
+
+#include "ComputeKernel.h"
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+// Blelloch up- and down-sweep over a tile of 512 elements, two per invocation
+const char * const scanTilesSource = R"(
+layout (local_size_x = 256) in;
+
+layout (std430, binding = 0) readonly buffer Input { T inputs[]; };
+layout (std430, binding = 1) writeonly buffer Output { T outputs[]; };
+layout (std430, binding = 2) writeonly buffer Sums { T sums[]; };
+
+uniform uint count;
+uniform bool inclusive;
+
+shared T tile[512];
+
+void main()
+{
+    uint group = groupIndex();
+    uint base = group * 512u;
+
+    if (base >= count)
+        return;
+
+    uint local = gl_LocalInvocationID.x;
+    uint a = base + local;
+    uint b = base + local + 256u;
+
+    T valueA = a < count ? inputs[a] : T(0);
+    T valueB = b < count ? inputs[b] : T(0);
+
+    tile[local] = valueA;
+    tile[local + 256u] = valueB;
+
+    uint offset = 1u;
+
+    for (uint d = 256u; d > 0u; d >>= 1u)
+    {
+        barrier();
+
+        if (local < d)
+        {
+            uint ai = offset * (2u * local + 1u) - 1u;
+            uint bi = offset * (2u * local + 2u) - 1u;
+            tile[bi] += tile[ai];
+        }
+
+        offset <<= 1u;
+    }
+
+    barrier();
+
+    if (local == 0u)
+    {
+        sums[group] = tile[511];
+        tile[511] = T(0);
+    }
+
+    for (uint d = 1u; d < 512u; d <<= 1u)
+    {
+        offset >>= 1u;
+
+        barrier();
+
+        if (local < d)
+        {
+            uint ai = offset * (2u * local + 1u) - 1u;
+            uint bi = offset * (2u * local + 2u) - 1u;
+            T t = tile[ai];
+            tile[ai] = tile[bi];
+            tile[bi] += t;
+        }
+    }
+
+    barrier();
+
+    if (a < count)
+        outputs[a] = tile[local] + (inclusive ? valueA : T(0));
+    if (b < count)
+        outputs[b] = tile[local + 256u] + (inclusive ? valueB : T(0));
+}
+)";
+
+// subgroup scans of consecutive element pairs, combined over the subgroups' totals
+const char * const scanTilesSubgroupSource = R"(
+layout (local_size_x = 256) in;
+
+layout (std430, binding = 0) readonly buffer Input { T inputs[]; };
+layout (std430, binding = 1) writeonly buffer Output { T outputs[]; };
+layout (std430, binding = 2) writeonly buffer Sums { T sums[]; };
+
+uniform uint count;
+uniform bool inclusive;
+
+shared T partials[256];
+
+void main()
+{
+    uint group = groupIndex();
+    uint base = group * 512u;
+
+    if (base >= count)
+        return;
+
+    uint a = base + 2u * gl_LocalInvocationID.x;
+    uint b = a + 1u;
+
+    T valueA = a < count ? inputs[a] : T(0);
+    T valueB = b < count ? inputs[b] : T(0);
+
+    T pair = valueA + valueB;
+    T prefix = subgroupExclusiveAdd(pair);
+    T total = subgroupAdd(pair);
+
+    if (subgroupElect())
+        partials[gl_SubgroupID] = total;
+
+    barrier();
+
+    if (gl_LocalInvocationID.x == 0u)
+    {
+        T running = T(0);
+
+        for (uint i = 0u; i < gl_NumSubgroups; ++i)
+        {
+            T t = partials[i];
+            partials[i] = running;
+            running += t;
+        }
+
+        sums[group] = running;
+    }
+
+    barrier();
+
+    T exclusive = partials[gl_SubgroupID] + prefix;
+
+    if (a < count)
+        outputs[a] = exclusive + (inclusive ? valueA : T(0));
+    if (b < count)
+        outputs[b] = exclusive + valueA + (inclusive ? valueB : T(0));
+}
+)";
+
+const char * const addBlockSumsSource = R"(
+layout (local_size_x = 256) in;
+
+layout (std430, binding = 1) buffer Output { T outputs[]; };
+layout (std430, binding = 2) readonly buffer Sums { T sums[]; };
+
+uniform uint count;
+
+void main()
+{
+    uint group = groupIndex();
+    uint base = group * 512u;
+
+    if (base >= count)
+        return;
+
+    T sum = sums[group];
+
+    uint a = base + gl_LocalInvocationID.x;
+    uint b = a + 256u;
+
+    if (a < count)
+        outputs[a] += sum;
+    if (b < count)
+        outputs[b] += sum;
+}
+)";
+
+
+std::string defines(const globjects::PrefixScan::Type type, const bool subgroups)
+{
+    std::string result;
+
+    if (subgroups)
+    {
+        result += "#extension GL_KHR_shader_subgroup_basic : require\n";
+        result += "#extension GL_KHR_shader_subgroup_arithmetic : require\n";
+    }
+
+    result += type == globjects::PrefixScan::Type::Float ? "#define T float\n" : "#define T uint\n";
+
+    return result;
+}
+
+GLuint tileCount(const GLuint count)
+{
+    return (count + globjects::PrefixScan::s_tileSize - 1) / globjects::PrefixScan::s_tileSize;
+}
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+PrefixScan::PrefixScan(const Type type, const bool allowSubgroups)
+: m_type(type)
+, m_subgroups(allowSubgroups && ComputeKernel::subgroupArithmeticSupported())
+, m_scanTiles(new ComputeKernel(defines(type, m_subgroups), m_subgroups ? scanTilesSubgroupSource : scanTilesSource))
+, m_addBlockSums(new ComputeKernel(defines(type, false), addBlockSumsSource))
+{
+}
+
+PrefixScan::~PrefixScan()
+{
+}
+
+void PrefixScan::scan(const Buffer * input, Buffer * output, const GLuint count, const Mode mode)
+{
+    assert(input != nullptr);
+    assert(output != nullptr);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    scanLevel(input, output, count, mode == Mode::Inclusive, 0);
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+PrefixScan::Type PrefixScan::type() const
+{
+    return m_type;
+}
+
+bool PrefixScan::usesSubgroups() const
+{
+    return m_subgroups;
+}
+
+void PrefixScan::scanLevel(const Buffer * input, Buffer * output, const GLuint count, const bool inclusive, const std::size_t level)
+{
+    const GLuint tiles = tileCount(count);
+
+    Buffer * sums = blockSums(level, tiles);
+
+    input->bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+    output->bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+    sums->bindBase(GL_SHADER_STORAGE_BUFFER, 2);
+
+    Program * program = m_scanTiles->program();
+    program->setUniform("count", count);
+    program->setUniform("inclusive", inclusive);
+
+    m_scanTiles->dispatch(tiles);
+
+    if (tiles == 1)
+    {
+        return;
+    }
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    // the exclusive scan of the tile totals is each tile's offset
+    scanLevel(sums, sums, tiles, false, level + 1);
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    output->bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+    sums->bindBase(GL_SHADER_STORAGE_BUFFER, 2);
+
+    m_addBlockSums->program()->setUniform("count", count);
+    m_addBlockSums->dispatch(tiles);
+}
+
+Buffer * PrefixScan::blockSums(const std::size_t level, const GLuint count)
+{
+    if (m_blockSums.size() <= level)
+    {
+        m_blockSums.resize(level + 1);
+        m_blockSumCapacities.resize(level + 1, 0);
+    }
+
+    if (!m_blockSums[level])
+    {
+        m_blockSums[level] = Buffer::create();
+    }
+
+    if (m_blockSumCapacities[level] < count)
+    {
+        // 4 bytes for both uint and float
+        m_blockSums[level]->setData(static_cast<GLsizeiptr>(count) * 4, nullptr, GL_DYNAMIC_COPY);
+        m_blockSumCapacities[level] = count;
+    }
+
+    return m_blockSums[level].get();
+}
+
+
+} // namespace globjects
@@ -21,6 +21,7 @@
 
 #include <globjects/Resource.h>
 #include "registry/ImplementationRegistry.h"
+#include "registry/BarrierTracker.h"
 #include "implementations/AbstractProgramBinaryImplementation.h"
 
 
@@ -630,9 +631,25 @@ void Program::dispatchCompute(const GLuint numGroupsX, const GLuint numGroupsY,
         return;
     }
 
+    BarrierTracker::current().command();
+
     glDispatchCompute(numGroupsX, numGroupsY, numGroupsZ);
 }
 
+void Program::dispatchComputeIndirect(const GLintptr offset)
+{
+    use();
+
+    if (!m_linked)
+    {
+        return;
+    }
+
+    BarrierTracker::current().command();
+
+    glDispatchComputeIndirect(offset);
+}
+
 void Program::dispatchComputeGroupSize(const GLuint numGroupsX, const GLuint numGroupsY, const GLuint numGroupsZ, const GLuint groupSizeX, const GLuint groupSizeY, const GLuint groupSizeZ)
 {
     use();
@@ -642,6 +659,8 @@ void Program::dispatchComputeGroupSize(const GLuint numGroupsX, const GLuint num
         return;
     }
 
+    BarrierTracker::current().command();
+
     glDispatchComputeGroupSizeARB(numGroupsX, numGroupsY, numGroupsZ, groupSizeX, groupSizeY, groupSizeZ);
 }
 
@@ -1,12 +1,17 @@
 
 #include <globjects/Query.h>
 
+#include <cassert>
+#include <thread>
+
 #include <glbinding/gl/functions.h>
 #include <glbinding/gl/boolean.h>
 #include <glbinding/gl/enum.h>
 
 #include <globjects/Resource.h>
+#include <globjects/Buffer.h>
 #include <globjects/DebugMessage.h>
+#include <globjects/AsyncPoller.h>
 
 
 using namespace gl;
@@ -143,9 +148,35 @@ bool Query::resultAvailable() const
     return static_cast<GLboolean>(get(GL_QUERY_RESULT_AVAILABLE)) == GL_TRUE;
 }
 
+AsyncResult<GLuint64> Query::result() const
+{
+    return result(GL_QUERY_RESULT);
+}
+
+AsyncResult<GLuint64> Query::result(const GLenum pname) const
+{
+    AsyncResult<GLuint64> result;
+
+    AsyncPoller::current().add([this, pname, result]() {
+        if (!resultAvailable())
+        {
+            return false;
+        }
+
+        result.resolve(get64(pname));
+
+        return true;
+    });
+
+    return result;
+}
+
 void Query::wait() const
 {
-    while (!resultAvailable());
+    while (!resultAvailable())
+    {
+        std::this_thread::yield();
+    }
 }
 
 void Query::wait(const std::chrono::duration<int, std::nano> & timeout) const
@@ -155,6 +186,8 @@ void Query::wait(const std::chrono::duration<int, std::nano> & timeout) const
     std::chrono::high_resolution_clock::time_point current;
     while (!resultAvailable() && start + timeout > current)
     {
+        std::this_thread::yield();
+
         current = std::chrono::high_resolution_clock::now();
     }
 }
@@ -197,6 +230,24 @@ GLuint64 Query::waitAndGet64(const GLenum pname, const std::chrono::duration<int
     return get64(pname);
 }
 
+void Query::getToBuffer(const GLenum pname, Buffer * buffer, const GLintptr offset) const
+{
+    assert(buffer != nullptr);
+
+    buffer->bind(GL_QUERY_BUFFER);
+    glGetQueryObjectuiv(id(), pname, reinterpret_cast<GLuint *>(offset));
+    Buffer::unbind(GL_QUERY_BUFFER);
+}
+
+void Query::getToBuffer64(const GLenum pname, Buffer * buffer, const GLintptr offset) const
+{
+    assert(buffer != nullptr);
+
+    buffer->bind(GL_QUERY_BUFFER);
+    glGetQueryObjectui64v(id(), pname, reinterpret_cast<GLuint64 *>(offset));
+    Buffer::unbind(GL_QUERY_BUFFER);
+}
+
 void Query::counter() const
 {
     counter(GL_TIMESTAMP);
@@ -0,0 +1,175 @@
+
+#include <globjects/QueryPool.h>
+
+#include <cassert>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Query.h>
+#include <globjects/Resource.h>
+
+
+using namespace gl;
+
+
+namespace globjects
+{
+
+
+QueryPool::QueryPool()
+{
+}
+
+QueryPool::~QueryPool()
+{
+}
+
+void QueryPool::reserve(const GLenum target, const GLsizei count)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    std::vector<GLuint> ids(static_cast<std::size_t>(count));
+    glGenQueries(count, ids.data());
+
+    auto & available = m_available[target];
+    available.reserve(available.size() + ids.size());
+
+    for (const auto id : ids)
+    {
+        available.push_back(std::unique_ptr<Query>(new Query(std::unique_ptr<IDResource>(new QueryResource(id)))));
+    }
+}
+
+Query * QueryPool::obtain(const GLenum target)
+{
+    auto & available = m_available[target];
+
+    if (available.empty())
+    {
+        reserve(target, 1);
+    }
+
+    std::unique_ptr<Query> query = std::move(available.back());
+    available.pop_back();
+
+    Query * result = query.get();
+    m_inUse[result] = Entry{ std::move(query), target };
+
+    return result;
+}
+
+void QueryPool::recycle(Query * query)
+{
+    assert(query != nullptr);
+
+    const auto it = m_inUse.find(query);
+
+    if (it == m_inUse.end())
+    {
+        return;
+    }
+
+    for (auto pendingIt = m_pending.begin(); pendingIt != m_pending.end(); )
+    {
+        pendingIt = pendingIt->query == query ? m_pending.erase(pendingIt) : pendingIt + 1;
+    }
+
+    m_available[it->second.target].push_back(std::move(it->second.query));
+    m_inUse.erase(it);
+}
+
+void QueryPool::resultAsync(Query * query, Callback callback, const bool recycleAfter)
+{
+    resultAsync(query, GL_QUERY_RESULT, std::move(callback), recycleAfter);
+}
+
+void QueryPool::resultAsync(Query * query, const GLenum pname, Callback callback, const bool recycleAfter)
+{
+    assert(query != nullptr);
+    assert(m_inUse.find(query) != m_inUse.end());
+
+    m_pending.push_back(Request{ query, pname, std::move(callback), recycleAfter });
+}
+
+std::future<GLuint64> QueryPool::resultAsync(Query * query, const bool recycleAfter)
+{
+    return resultAsync(query, GL_QUERY_RESULT, recycleAfter);
+}
+
+std::future<GLuint64> QueryPool::resultAsync(Query * query, const GLenum pname, const bool recycleAfter)
+{
+    auto promise = std::make_shared<std::promise<GLuint64>>();
+
+    resultAsync(query, pname, [promise](const GLuint64 value) {
+        promise->set_value(value);
+    }, recycleAfter);
+
+    return promise->get_future();
+}
+
+std::size_t QueryPool::poll()
+{
+    if (m_pending.empty())
+    {
+        return 0;
+    }
+
+    std::vector<Request> pending;
+    std::vector<std::pair<Request, GLuint64>> ready;
+
+    pending.swap(m_pending);
+
+    for (auto & request : pending)
+    {
+        if (request.query->resultAvailable())
+        {
+            const GLuint64 value = request.query->get64(request.pname);
+
+            ready.emplace_back(std::move(request), value);
+        }
+        else
+        {
+            m_pending.push_back(std::move(request));
+        }
+    }
+
+    // Callbacks may obtain and request further queries, so the pending list has to be consistent at this point
+    for (auto & pair : ready)
+    {
+        if (pair.first.recycleAfter)
+        {
+            recycle(pair.first.query);
+        }
+
+        if (pair.first.callback)
+        {
+            pair.first.callback(pair.second);
+        }
+    }
+
+    return ready.size();
+}
+
+std::size_t QueryPool::pendingCount() const
+{
+    return m_pending.size();
+}
+
+std::size_t QueryPool::inUseCount() const
+{
+    return m_inUse.size();
+}
+
+std::size_t QueryPool::availableCount(const GLenum target) const
+{
+    const auto it = m_available.find(target);
+
+    return it == m_available.end() ? 0 : it->second.size();
+}
+
+
+} // namespace globjects
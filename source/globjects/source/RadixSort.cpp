@@ -0,0 +1,366 @@
+
+#include <globjects/RadixSort.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <utility>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/PrefixScan.h>
+#include <globjects/Program.h>
+
+#include "ComputeKernel.h"
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+const GLuint digitCount = 1u << globjects::RadixSort::s_bitsPerPass;
+
+
+// std430 layout of the state buffer: count, then the dispatch arguments
+const char * const stateDeclaration = R"(
+layout (std430, binding = 2) buffer State
+{
+    uint count;
+    uint groupsX;
+    uint groupsY;
+    uint groupsZ;
+};
+)";
+
+const char * const setupSource = R"(
+layout (local_size_x = 1) in;
+
+uniform uint maxCount;
+
+void main()
+{
+    count = min(count, maxCount);
+
+    uint groups = (count + 1023u) / 1024u;
+
+    groupsX = min(groups, 65535u);
+    groupsY = groupsX == 0u ? 1u : (groups + groupsX - 1u) / groupsX;
+    groupsZ = 1u;
+}
+)";
+
+// per tile digit counts, written digit-major so that one scan yields all offsets
+const char * const histogramSource = R"(
+layout (local_size_x = 256) in;
+
+layout (std430, binding = 0) readonly buffer Keys { uint keys[]; };
+layout (std430, binding = 1) writeonly buffer Histograms { uint histograms[]; };
+
+uniform uint shift;
+uniform uint digitMask;
+uniform uint groupStride;
+
+shared uint bins[16];
+
+void main()
+{
+    uint group = groupIndex();
+
+    if (group >= groupStride)
+        return;
+
+    uint local = gl_LocalInvocationID.x;
+
+    if (local < 16u)
+        bins[local] = 0u;
+
+    barrier();
+
+    uint base = group * 1024u + local * 4u;
+
+    for (uint i = 0u; i < 4u; ++i)
+    {
+        if (base + i < count)
+            atomicAdd(bins[(keys[base + i] >> shift) & digitMask], 1u);
+    }
+
+    barrier();
+
+    if (local < 16u)
+        histograms[local * groupStride + group] = bins[local];
+}
+)";
+
+// stable scatter: ranks within the tile from a per digit scan over the invocations
+const char * const scatterSource = R"(
+layout (local_size_x = 256) in;
+
+layout (std430, binding = 0) readonly buffer KeysIn { uint keysIn[]; };
+layout (std430, binding = 1) writeonly buffer KeysOut { uint keysOut[]; };
+layout (std430, binding = 3) readonly buffer Offsets { uint offsets[]; };
+#ifdef VALUES
+layout (std430, binding = 4) readonly buffer ValuesIn { uint valuesIn[]; };
+layout (std430, binding = 5) writeonly buffer ValuesOut { uint valuesOut[]; };
+#endif
+
+uniform uint shift;
+uniform uint digitMask;
+uniform uint groupStride;
+
+shared uint counts[16 * 256];
+
+void main()
+{
+    uint group = groupIndex();
+
+    if (group >= groupStride)
+        return;
+
+    uint local = gl_LocalInvocationID.x;
+    uint base = group * 1024u + local * 4u;
+
+    uint key[4];
+    uint digit[4];
+    uint own[16];
+
+    for (uint d = 0u; d < 16u; ++d)
+        own[d] = 0u;
+
+    for (uint i = 0u; i < 4u; ++i)
+    {
+        key[i] = base + i < count ? keysIn[base + i] : 0u;
+        digit[i] = (key[i] >> shift) & digitMask;
+
+        if (base + i < count)
+            ++own[digit[i]];
+    }
+
+    for (uint d = 0u; d < 16u; ++d)
+        counts[d * 256u + local] = own[d];
+
+    // inclusive Hillis-Steele scan per digit over the invocations
+    for (uint s = 1u; s < 256u; s <<= 1u)
+    {
+        uint previous[16];
+
+        barrier();
+
+        for (uint d = 0u; d < 16u; ++d)
+            previous[d] = local >= s ? counts[d * 256u + local - s] : 0u;
+
+        barrier();
+
+        for (uint d = 0u; d < 16u; ++d)
+            counts[d * 256u + local] += previous[d];
+    }
+
+    barrier();
+
+    uint position[16];
+
+    for (uint d = 0u; d < 16u; ++d)
+        position[d] = offsets[d * groupStride + group] + counts[d * 256u + local] - own[d];
+
+    for (uint i = 0u; i < 4u; ++i)
+    {
+        if (base + i >= count)
+            break;
+
+        uint target = position[digit[i]]++;
+
+        keysOut[target] = key[i];
+#ifdef VALUES
+        valuesOut[target] = valuesIn[base + i];
+#endif
+    }
+}
+)";
+
+
+GLuint tileCount(const GLuint count)
+{
+    return (count + globjects::RadixSort::s_tileSize - 1) / globjects::RadixSort::s_tileSize;
+}
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+RadixSort::RadixSort()
+: m_setup(new ComputeKernel(stateDeclaration, setupSource))
+, m_histogram(new ComputeKernel(stateDeclaration, histogramSource))
+, m_scatterKeys(new ComputeKernel(stateDeclaration, scatterSource))
+, m_scatterPairs(new ComputeKernel(std::string("#define VALUES\n") + stateDeclaration, scatterSource))
+, m_scan(PrefixScan::create(PrefixScan::Type::UnsignedInt))
+, m_state(Buffer::create())
+, m_histograms(Buffer::create())
+, m_offsets(Buffer::create())
+, m_keys(Buffer::create())
+, m_values(Buffer::create())
+, m_capacity(0)
+, m_valueCapacity(0)
+{
+    static_assert(digitCount == 16, "kernels assume 4 bit digits");
+
+    m_state->setData(std::array<GLuint, 4>{{ 0, 0, 1, 1 }}, GL_DYNAMIC_COPY);
+}
+
+RadixSort::~RadixSort()
+{
+}
+
+void RadixSort::sort(Buffer * keys, const GLuint count, const GLuint keyBits)
+{
+    sort(keys, nullptr, count, keyBits);
+}
+
+void RadixSort::sort(Buffer * keys, Buffer * values, const GLuint count, const GLuint keyBits)
+{
+    assert(keys != nullptr);
+
+    if (count < 2)
+    {
+        return;
+    }
+
+    m_state->setSubData(0, static_cast<GLsizeiptr>(sizeof(GLuint)), &count);
+
+    run(keys, values, count, false, keyBits);
+}
+
+void RadixSort::sortIndirect(Buffer * keys, Buffer * values, const Buffer * countBuffer, const GLintptr countOffset, const GLuint maxCount, const GLuint keyBits)
+{
+    assert(keys != nullptr);
+    assert(countBuffer != nullptr);
+
+    if (maxCount < 2)
+    {
+        return;
+    }
+
+    countBuffer->copySubData(m_state.get(), countOffset, 0, static_cast<GLsizeiptr>(sizeof(GLuint)));
+
+    m_state->bindBase(GL_SHADER_STORAGE_BUFFER, 2);
+
+    m_setup->program()->setUniform("maxCount", maxCount);
+    m_setup->dispatch(1);
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+    run(keys, values, maxCount, true, keyBits);
+}
+
+void RadixSort::run(Buffer * keys, Buffer * values, const GLuint maxCount, const bool indirect, const GLuint keyBits)
+{
+    reserve(maxCount, values != nullptr);
+
+    const GLuint groups = tileCount(maxCount);
+
+    if (indirect)
+    {
+        // tiles beyond the actual count are not dispatched and have to count as empty
+        m_histograms->clearSubData(GL_R32UI, 0, static_cast<GLsizeiptr>(digitCount * groups * sizeof(GLuint)), GL_RED_INTEGER, GL_UNSIGNED_INT);
+    }
+
+    const GLuint digitPasses = (std::min(keyBits, 32u) + s_bitsPerPass - 1) / s_bitsPerPass;
+
+    // an even number of passes leaves the result in keys and values; an extra
+    // pass uses a digit mask of 0, so it stably copies instead of sorting by
+    // bits above keyBits
+    const GLuint passes = digitPasses + digitPasses % 2;
+
+    const ComputeKernel & scatter = values ? *m_scatterPairs : *m_scatterKeys;
+
+    Buffer * keysIn = keys;
+    Buffer * keysOut = m_keys.get();
+    Buffer * valuesIn = values;
+    Buffer * valuesOut = m_values.get();
+
+    m_state->bindBase(GL_SHADER_STORAGE_BUFFER, 2);
+
+    for (GLuint pass = 0; pass < passes; ++pass)
+    {
+        const GLuint shift = pass < digitPasses ? pass * s_bitsPerPass : 0u;
+        const GLuint digitMask = pass < digitPasses ? digitCount - 1 : 0u;
+
+        keysIn->bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+        m_histograms->bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+
+        m_histogram->program()->setUniform("shift", shift);
+        m_histogram->program()->setUniform("digitMask", digitMask);
+        m_histogram->program()->setUniform("groupStride", groups);
+        dispatch(*m_histogram, groups, indirect);
+
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        m_scan->scan(m_histograms.get(), m_offsets.get(), digitCount * groups);
+
+        // the scan uses binding points 0 to 2 as well
+        keysIn->bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+        keysOut->bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+        m_state->bindBase(GL_SHADER_STORAGE_BUFFER, 2);
+        m_offsets->bindBase(GL_SHADER_STORAGE_BUFFER, 3);
+
+        if (values)
+        {
+            valuesIn->bindBase(GL_SHADER_STORAGE_BUFFER, 4);
+            valuesOut->bindBase(GL_SHADER_STORAGE_BUFFER, 5);
+        }
+
+        scatter.program()->setUniform("shift", shift);
+        scatter.program()->setUniform("digitMask", digitMask);
+        scatter.program()->setUniform("groupStride", groups);
+        dispatch(scatter, groups, indirect);
+
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        std::swap(keysIn, keysOut);
+        std::swap(valuesIn, valuesOut);
+    }
+}
+
+void RadixSort::dispatch(const ComputeKernel & kernel, const GLuint groups, const bool indirect) const
+{
+    if (indirect)
+    {
+        kernel.dispatchIndirect(m_state.get(), static_cast<GLintptr>(sizeof(GLuint)));
+    }
+    else
+    {
+        kernel.dispatch(groups);
+    }
+}
+
+void RadixSort::reserve(const GLuint count, const bool values)
+{
+    if (count > m_capacity)
+    {
+        m_capacity = std::max(count, m_capacity * 2);
+
+        const GLuint groups = tileCount(m_capacity);
+
+        m_keys->setData(static_cast<GLsizeiptr>(m_capacity) * static_cast<GLsizeiptr>(sizeof(GLuint)), nullptr, GL_DYNAMIC_COPY);
+        m_histograms->setData(static_cast<GLsizeiptr>(digitCount * groups) * static_cast<GLsizeiptr>(sizeof(GLuint)), nullptr, GL_DYNAMIC_COPY);
+        m_offsets->setData(static_cast<GLsizeiptr>(digitCount * groups) * static_cast<GLsizeiptr>(sizeof(GLuint)), nullptr, GL_DYNAMIC_COPY);
+    }
+
+    if (values && m_valueCapacity < m_capacity)
+    {
+        m_valueCapacity = m_capacity;
+
+        m_values->setData(static_cast<GLsizeiptr>(m_valueCapacity) * static_cast<GLsizeiptr>(sizeof(GLuint)), nullptr, GL_DYNAMIC_COPY);
+    }
+}
+
+
+} // namespace globjects
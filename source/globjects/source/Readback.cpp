@@ -0,0 +1,103 @@
+
+#include <globjects/Readback.h>
+
+#include <cassert>
+#include <cstring>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/AsyncPoller.h>
+#include <globjects/Buffer.h>
+#include <globjects/Sync.h>
+
+
+using namespace gl;
+
+
+namespace globjects
+{
+
+
+Readback::Readback(std::shared_ptr<Buffer> staging, const GLsizeiptr size)
+: m_staging(std::move(staging))
+, m_size(size)
+, m_data(nullptr)
+{
+    assert(m_staging != nullptr);
+
+    if (m_size > 0)
+    {
+        m_data = static_cast<const unsigned char *>(m_staging->mapRange(0, m_size, GL_MAP_READ_BIT));
+    }
+}
+
+Readback::~Readback()
+{
+    if (m_data)
+    {
+        m_staging->unmap();
+    }
+}
+
+const unsigned char * Readback::data() const
+{
+    return m_data;
+}
+
+std::size_t Readback::size() const
+{
+    return m_data ? static_cast<std::size_t>(m_size) : 0u;
+}
+
+Readback::Result Readback::fenced(std::shared_ptr<Buffer> staging, const GLsizeiptr size)
+{
+    Result result;
+
+    std::shared_ptr<Sync> fence = Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE);
+
+    AsyncPoller::current().add([staging, fence, size, result]() {
+        if (!fence->isSignaled())
+        {
+            return false;
+        }
+
+        result.resolve(std::make_shared<Readback>(staging, size));
+
+        return true;
+    });
+
+    return result;
+}
+
+AsyncResult<std::vector<unsigned char>> Readback::toVector(const Result & readback)
+{
+    AsyncResult<std::vector<unsigned char>> result;
+
+    readback.then([result](const std::shared_ptr<const Readback> & mapped) {
+        result.resolve(std::vector<unsigned char>(mapped->data(), mapped->data() + mapped->size()));
+    });
+
+    return result;
+}
+
+AsyncResult<bool> Readback::copyTo(const Result & readback, void * data)
+{
+    assert(data != nullptr);
+
+    AsyncResult<bool> result;
+
+    readback.then([result, data](const std::shared_ptr<const Readback> & mapped) {
+        if (mapped->size() > 0)
+        {
+            std::memcpy(data, mapped->data(), mapped->size());
+        }
+
+        result.resolve(mapped->size() > 0);
+    });
+
+    return result;
+}
+
+
+} // namespace globjects
@@ -0,0 +1,317 @@
+
+#include <globjects/Reduction.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/Program.h>
+#include <globjects/Texture.h>
+
+#include "ComputeKernel.h"
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+// one partial result per tile: value and index of the selected element
+const char * const reduceSource = R"(
+layout (local_size_x = 256) in;
+
+struct Partial
+{
+    T value;
+    uint index;
+};
+
+#if defined(SOURCE_BUFFER)
+layout (std430, binding = 0) readonly buffer Input { T inputs[]; };
+#elif defined(SOURCE_PARTIALS)
+layout (std430, binding = 0) readonly buffer Input { Partial inputs[]; };
+#else
+uniform SAMPLER source;
+uniform int level;
+uniform int component;
+#endif
+
+layout (std430, binding = 1) writeonly buffer Output { Partial outputs[]; };
+
+uniform uint count;
+
+shared Partial partials[256];
+
+Partial load(uint index)
+{
+#if defined(SOURCE_BUFFER)
+    return Partial(inputs[index], index);
+#elif defined(SOURCE_PARTIALS)
+    return inputs[index];
+#else
+    ivec2 size = textureSize(source, level);
+    ivec2 position = ivec2(int(index) % size.x, int(index) / size.x);
+    TEXEL texel = texelFetch(source, position, level);
+
+    T value = component < 0 ? T(dot(vec3(texel.rgb), vec3(0.2126, 0.7152, 0.0722))) : texel[component];
+
+    return Partial(value, index);
+#endif
+}
+
+Partial combine(Partial a, Partial b)
+{
+#if defined(OP_SUM)
+    return Partial(a.value + b.value, 0u);
+#elif defined(OP_MIN)
+    return b.value < a.value || (b.value == a.value && b.index < a.index) ? b : a;
+#else
+    return b.value > a.value || (b.value == a.value && b.index < a.index) ? b : a;
+#endif
+}
+
+void main()
+{
+    uint group = groupIndex();
+    uint local = gl_LocalInvocationID.x;
+    uint base = group * 512u + local;
+
+    if (group * 512u >= count)
+        return;
+
+    Partial partial = Partial(IDENTITY, 0xffffffffu);
+
+    if (base < count)
+        partial = combine(partial, load(base));
+    if (base + 256u < count)
+        partial = combine(partial, load(base + 256u));
+
+    partials[local] = partial;
+
+    barrier();
+
+    for (uint s = 128u; s > 0u; s >>= 1u)
+    {
+        if (local < s)
+            partials[local] = combine(partials[local], partials[local + s]);
+
+        barrier();
+    }
+
+    if (local == 0u)
+        outputs[group] = partials[0];
+}
+)";
+
+
+std::string defines(const globjects::Reduction::Operation operation, const globjects::Reduction::Type type, const std::string & source)
+{
+    using Operation = globjects::Reduction::Operation;
+    using Type = globjects::Reduction::Type;
+
+    const bool sum = operation == Operation::Sum;
+    const bool min = operation == Operation::Min || operation == Operation::ArgMin;
+
+    std::string result = "#define " + source + "\n";
+    result += sum ? "#define OP_SUM\n" : (min ? "#define OP_MIN\n" : "#define OP_MAX\n");
+
+    switch (type)
+    {
+    case Type::UnsignedInt:
+        result += "#define T uint\n#define TEXEL uvec4\n#define SAMPLER usampler2D\n";
+        result += std::string("#define IDENTITY ") + (sum ? "0u" : (min ? "0xffffffffu" : "0u")) + "\n";
+        break;
+
+    case Type::Int:
+        result += "#define T int\n#define TEXEL ivec4\n#define SAMPLER isampler2D\n";
+        result += std::string("#define IDENTITY ") + (sum ? "0" : (min ? "0x7fffffff" : "int(0x80000000u)")) + "\n";
+        break;
+
+    default:
+        result += "#define T float\n#define TEXEL vec4\n#define SAMPLER sampler2D\n";
+        result += std::string("#define IDENTITY ") + (sum ? "0.0" : (min ? "uintBitsToFloat(0x7f800000u)" : "uintBitsToFloat(0xff800000u)")) + "\n";
+        break;
+    }
+
+    return result;
+}
+
+GLuint tileCount(const GLuint count)
+{
+    return (count + globjects::Reduction::s_tileSize - 1) / globjects::Reduction::s_tileSize;
+}
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+Reduction::Result::Result()
+: bits(0)
+, index(0)
+{
+}
+
+Reduction::Reduction(const Operation operation, const Type type)
+: m_operation(operation)
+, m_type(type)
+, m_buffer(new ComputeKernel(defines(operation, type, "SOURCE_BUFFER"), reduceSource))
+, m_texture(new ComputeKernel(defines(operation, type, "SOURCE_TEXTURE"), reduceSource))
+, m_partials(new ComputeKernel(defines(operation, type, "SOURCE_PARTIALS"), reduceSource))
+, m_partialsA(Buffer::create())
+, m_partialsB(Buffer::create())
+, m_result(Buffer::create())
+, m_capacity(0)
+{
+    m_result->setData(std::array<GLuint, 2>{{ 0, 0 }}, GL_DYNAMIC_COPY);
+}
+
+Reduction::~Reduction()
+{
+}
+
+Reduction::Operation Reduction::operation() const
+{
+    return m_operation;
+}
+
+Reduction::Type Reduction::type() const
+{
+    return m_type;
+}
+
+void Reduction::reduce(const Buffer * input, const GLuint count)
+{
+    assert(input != nullptr);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    const GLuint groups = tileCount(count);
+
+    reserve(groups);
+
+    input->bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+    target(groups)->bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+
+    m_buffer->program()->setUniform("count", count);
+    m_buffer->dispatch(groups);
+
+    reducePartials(groups);
+}
+
+void Reduction::reduce(const Texture * texture, const GLint level, const GLint component)
+{
+    assert(texture != nullptr);
+    assert(component >= s_luminance && component < 4);
+
+    const GLint width = texture->getLevelParameter(level, GL_TEXTURE_WIDTH);
+    const GLint height = texture->getLevelParameter(level, GL_TEXTURE_HEIGHT);
+    const GLuint count = static_cast<GLuint>(width * height);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    const GLuint groups = tileCount(count);
+
+    reserve(groups);
+
+    texture->bindActive(0u);
+    target(groups)->bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+
+    Program * program = m_texture->program();
+    program->setUniform("source", 0);
+    program->setUniform("level", level);
+    program->setUniform("component", component);
+    program->setUniform("count", count);
+    m_texture->dispatch(groups);
+
+    reducePartials(groups);
+}
+
+void Reduction::reducePartials(GLuint count)
+{
+    Buffer * input = m_partialsA.get();
+    Buffer * output = m_partialsB.get();
+
+    while (count > 1)
+    {
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        const GLuint groups = tileCount(count);
+
+        input->bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+        (groups == 1 ? m_result.get() : output)->bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+
+        m_partials->program()->setUniform("count", count);
+        m_partials->dispatch(groups);
+
+        std::swap(input, output);
+        count = groups;
+    }
+
+    // make the result visible to shader storage, uniform and buffer reads alike
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_UNIFORM_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+Buffer * Reduction::result() const
+{
+    return m_result.get();
+}
+
+AsyncResult<Reduction::Result> Reduction::resultAsync() const
+{
+    AsyncResult<Result> result;
+
+    m_result->readAsync(0, static_cast<GLsizeiptr>(2 * sizeof(GLuint))).then([result](const std::vector<unsigned char> & data) {
+        Result value;
+        std::memcpy(&value.bits, data.data(), sizeof(GLuint));
+        std::memcpy(&value.index, data.data() + sizeof(GLuint), sizeof(GLuint));
+
+        result.resolve(value);
+    });
+
+    return result;
+}
+
+Buffer * Reduction::target(const GLuint groups) const
+{
+    return groups == 1 ? m_result.get() : m_partialsA.get();
+}
+
+void Reduction::reserve(const GLuint groups)
+{
+    if (groups <= m_capacity)
+    {
+        return;
+    }
+
+    m_capacity = std::max(groups, m_capacity * 2);
+
+    const GLsizeiptr size = static_cast<GLsizeiptr>(m_capacity) * static_cast<GLsizeiptr>(2 * sizeof(GLuint));
+
+    m_partialsA->setData(size, nullptr, GL_DYNAMIC_COPY);
+    m_partialsB->setData(size, nullptr, GL_DYNAMIC_COPY);
+}
+
+
+} // namespace globjects
@@ -0,0 +1,313 @@
+
+#include <globjects/RenderJobScheduler.h>
+
+#include <cassert>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Framebuffer.h>
+#include <globjects/Renderbuffer.h>
+
+#include "registry/Registry.h"
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+// per-worker render target, reallocated when size or formats change
+struct Target
+{
+    Target()
+    : width(0)
+    , height(0)
+    , colorFormat(GL_NONE)
+    , depthFormat(GL_NONE)
+    {
+    }
+
+    void prepare(const globjects::RenderJobScheduler::Job & job)
+    {
+        if (framebuffer && job.width == width && job.height == height && job.colorFormat == colorFormat && job.depthFormat == depthFormat)
+        {
+            return;
+        }
+
+        framebuffer = globjects::Framebuffer::create();
+
+        color = globjects::Renderbuffer::create();
+        color->storage(job.colorFormat, job.width, job.height);
+        framebuffer->attachRenderBuffer(GL_COLOR_ATTACHMENT0, color.get());
+
+        depth.reset();
+
+        if (job.depthFormat != GL_NONE)
+        {
+            depth = globjects::Renderbuffer::create();
+            depth->storage(job.depthFormat, job.width, job.height);
+            framebuffer->attachRenderBuffer(GL_DEPTH_ATTACHMENT, depth.get());
+        }
+
+        width = job.width;
+        height = job.height;
+        colorFormat = job.colorFormat;
+        depthFormat = job.depthFormat;
+    }
+
+    std::unique_ptr<globjects::Framebuffer> framebuffer;
+    std::unique_ptr<globjects::Renderbuffer> color;
+    std::unique_ptr<globjects::Renderbuffer> depth;
+
+    GLsizei width;
+    GLsizei height;
+    GLenum colorFormat;
+    GLenum depthFormat;
+};
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+RenderJobScheduler::Readback::Readback()
+: attachment(GL_COLOR_ATTACHMENT0)
+, format(GL_RGBA)
+, type(GL_UNSIGNED_BYTE)
+, rect{{ 0, 0, 0, 0 }}
+{
+}
+
+RenderJobScheduler::Job::Job(const GLsizei width, const GLsizei height, std::function<void(Framebuffer *)> render)
+: width(width)
+, height(height)
+, colorFormat(GL_RGBA8)
+, depthFormat(GL_DEPTH_COMPONENT24)
+, render(std::move(render))
+{
+}
+
+RenderJobScheduler::Task::Task(Job && job)
+: job(std::move(job))
+{
+}
+
+RenderJobScheduler::RenderJobScheduler(const std::vector<WorkerContext> & contexts, const glbinding::GetProcAddress functionPointerResolver)
+: m_functionPointerResolver(functionPointerResolver)
+, m_shareObjects(false)
+, m_sharedContextId(0)
+, m_next(0)
+, m_queued(0)
+, m_running(true)
+{
+    start(contexts);
+}
+
+RenderJobScheduler::RenderJobScheduler(const std::vector<WorkerContext> & contexts, const glbinding::GetProcAddress functionPointerResolver, const glbinding::ContextHandle sharedContextId)
+: m_functionPointerResolver(functionPointerResolver)
+, m_shareObjects(true)
+, m_sharedContextId(sharedContextId)
+, m_next(0)
+, m_queued(0)
+, m_running(true)
+{
+    start(contexts);
+}
+
+RenderJobScheduler::~RenderJobScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_running = false;
+    }
+
+    m_condition.notify_all();
+
+    for (auto & worker : m_workers)
+    {
+        worker->thread.join();
+    }
+}
+
+std::future<RenderJobScheduler::Result> RenderJobScheduler::submit(Job job)
+{
+    assert(!m_workers.empty());
+
+    Task task(std::move(job));
+    std::future<Result> result = task.promise.get_future();
+
+    {
+        Worker & worker = *m_workers[m_next.fetch_add(1u, std::memory_order_relaxed) % m_workers.size()];
+
+        std::lock_guard<std::mutex> lock(worker.mutex);
+
+        worker.queue.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        ++m_queued;
+    }
+
+    m_condition.notify_one();
+
+    return result;
+}
+
+std::size_t RenderJobScheduler::workerCount() const
+{
+    return m_workers.size();
+}
+
+std::size_t RenderJobScheduler::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_queued > 0 ? static_cast<std::size_t>(m_queued) : 0;
+}
+
+void RenderJobScheduler::start(const std::vector<WorkerContext> & contexts)
+{
+    m_workers.reserve(contexts.size());
+
+    for (const auto & context : contexts)
+    {
+        std::unique_ptr<Worker> worker(new Worker);
+        worker->context = context;
+
+        m_workers.push_back(std::move(worker));
+    }
+
+    // threads are started after all workers exist, as they steal from each other
+    for (std::size_t i = 0; i < m_workers.size(); ++i)
+    {
+        m_workers[i]->thread = std::thread(&RenderJobScheduler::run, this, i);
+    }
+}
+
+bool RenderJobScheduler::take(const std::size_t index, std::unique_ptr<Task> & task)
+{
+    const std::size_t count = m_workers.size();
+
+    // own queue first (oldest job), then steal the newest job of other workers
+    for (std::size_t i = 0; i < count && !task; ++i)
+    {
+        Worker & worker = *m_workers[(index + i) % count];
+
+        std::lock_guard<std::mutex> lock(worker.mutex);
+
+        if (worker.queue.empty())
+        {
+            continue;
+        }
+
+        if (i == 0)
+        {
+            task.reset(new Task(std::move(worker.queue.front())));
+            worker.queue.pop_front();
+        }
+        else
+        {
+            task.reset(new Task(std::move(worker.queue.back())));
+            worker.queue.pop_back();
+        }
+    }
+
+    if (!task)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    --m_queued;
+
+    return true;
+}
+
+void RenderJobScheduler::run(const std::size_t index)
+{
+    const WorkerContext & context = m_workers[index]->context;
+
+    context.makeCurrent();
+
+    if (m_shareObjects)
+    {
+        registerContext(context.handle, m_functionPointerResolver, m_sharedContextId);
+    }
+    else
+    {
+        registerContext(context.handle, m_functionPointerResolver);
+    }
+
+    {
+        Target target;
+
+        while (true)
+        {
+            std::unique_ptr<Task> task;
+
+            if (!take(index, task))
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                m_condition.wait(lock, [this]() { return !m_running || m_queued > 0; });
+
+                if (!m_running && m_queued <= 0)
+                {
+                    break;
+                }
+
+                continue;
+            }
+
+            Job & job = task->job;
+
+            try
+            {
+                target.prepare(job);
+
+                target.framebuffer->bind(GL_FRAMEBUFFER);
+
+                glViewport(0, 0, job.width, job.height);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+                job.render(target.framebuffer.get());
+
+                std::array<GLint, 4> rect = job.readback.rect;
+
+                if (rect[2] == 0 || rect[3] == 0)
+                {
+                    rect = {{ 0, 0, job.width, job.height }};
+                }
+
+                target.framebuffer->bind(GL_FRAMEBUFFER);
+
+                task->promise.set_value(target.framebuffer->readPixelsToByteArray(job.readback.attachment, rect, job.readback.format, job.readback.type));
+            }
+            catch (...)
+            {
+                task->promise.set_exception(std::current_exception());
+            }
+        }
+
+        Framebuffer::unbind(GL_FRAMEBUFFER);
+    }
+
+    Registry::deregisterContext(context.handle);
+
+    context.doneCurrent();
+}
+
+
+} // namespace globjects
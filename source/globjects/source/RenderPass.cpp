@@ -0,0 +1,167 @@
+
+#include <globjects/RenderPass.h>
+
+#include <cassert>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/extension.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Framebuffer.h>
+#include <globjects/FramebufferCache.h>
+
+
+using namespace gl;
+
+
+namespace globjects
+{
+
+
+RenderPass::RenderPass(Framebuffer * framebuffer, FramebufferCache * cache)
+: m_framebuffer(framebuffer)
+, m_cache(cache)
+, m_invalidateSupported(hasExtension(GLextension::GL_ARB_invalidate_subdata))
+, m_hasDepth(false)
+, m_depth{ GL_NONE, LoadOp::Load, StoreOp::Store }
+, m_clearDepth(1.0f)
+, m_hasStencil(false)
+, m_stencil{ GL_NONE, LoadOp::Load, StoreOp::Store }
+, m_clearStencil(0)
+{
+    assert(framebuffer != nullptr);
+}
+
+RenderPass::~RenderPass()
+{
+}
+
+Framebuffer * RenderPass::framebuffer() const
+{
+    return m_framebuffer;
+}
+
+void RenderPass::setColorAttachment(const GLenum attachment, const LoadOp load, const StoreOp store, const glm::vec4 & clearColor)
+{
+    for (std::size_t i = 0; i < m_colors.size(); ++i)
+    {
+        if (m_colors[i].attachment == attachment)
+        {
+            m_colors[i] = Attachment{ attachment, load, store };
+            m_clearColors[i] = clearColor;
+
+            return;
+        }
+    }
+
+    m_colors.push_back(Attachment{ attachment, load, store });
+    m_clearColors.push_back(clearColor);
+
+    if (!m_framebuffer->isDefault())
+    {
+        m_drawBuffers.push_back(attachment);
+    }
+}
+
+void RenderPass::setDepthAttachment(const LoadOp load, const StoreOp store, const float clearDepth)
+{
+    m_hasDepth = true;
+    m_depth = Attachment{ m_framebuffer->isDefault() ? GL_DEPTH : GL_DEPTH_ATTACHMENT, load, store };
+    m_clearDepth = clearDepth;
+}
+
+void RenderPass::setStencilAttachment(const LoadOp load, const StoreOp store, const GLint clearStencil)
+{
+    m_hasStencil = true;
+    m_stencil = Attachment{ m_framebuffer->isDefault() ? GL_STENCIL : GL_STENCIL_ATTACHMENT, load, store };
+    m_clearStencil = clearStencil;
+}
+
+void RenderPass::begin()
+{
+    m_framebuffer->bind();
+
+    if (!m_drawBuffers.empty())
+    {
+        if (m_cache)
+        {
+            m_cache->setDrawBuffers(m_framebuffer, m_drawBuffers);
+        }
+        else
+        {
+            m_framebuffer->setDrawBuffers(m_drawBuffers);
+        }
+    }
+
+    // previous contents of DontCare attachments need not be loaded
+    invalidate(true);
+
+    for (std::size_t i = 0; i < m_colors.size(); ++i)
+    {
+        if (m_colors[i].load == LoadOp::Clear)
+        {
+            m_framebuffer->clearBuffer(GL_COLOR, static_cast<GLint>(i), m_clearColors[i]);
+        }
+    }
+
+    const bool clearDepth = m_hasDepth && m_depth.load == LoadOp::Clear;
+    const bool clearStencil = m_hasStencil && m_stencil.load == LoadOp::Clear;
+
+    if (clearDepth && clearStencil)
+    {
+        m_framebuffer->clearBuffer(GL_DEPTH_STENCIL, m_clearDepth, m_clearStencil);
+    }
+    else if (clearDepth)
+    {
+        m_framebuffer->clearBuffer(GL_DEPTH, 0, m_clearDepth);
+    }
+    else if (clearStencil)
+    {
+        m_framebuffer->clearBuffer(GL_STENCIL, 0, static_cast<int>(m_clearStencil));
+    }
+}
+
+void RenderPass::end()
+{
+    invalidate(false);
+}
+
+void RenderPass::invalidate(const bool loading)
+{
+    if (!m_invalidateSupported)
+    {
+        return;
+    }
+
+    const auto discarded = [loading](const Attachment & attachment) {
+        return loading ? attachment.load == LoadOp::DontCare : attachment.store == StoreOp::DontCare;
+    };
+
+    m_invalidated.clear();
+
+    for (const auto & color : m_colors)
+    {
+        if (discarded(color))
+        {
+            m_invalidated.push_back(color.attachment);
+        }
+    }
+
+    if (m_hasDepth && discarded(m_depth))
+    {
+        m_invalidated.push_back(m_depth.attachment);
+    }
+
+    if (m_hasStencil && discarded(m_stencil))
+    {
+        m_invalidated.push_back(m_stencil.attachment);
+    }
+
+    if (!m_invalidated.empty())
+    {
+        m_framebuffer->invalidate(m_invalidated);
+    }
+}
+
+
+} // namespace globjects
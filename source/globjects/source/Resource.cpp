@@ -4,6 +4,8 @@
 #include <glbinding/gl/functions.h>
 
 #include "registry/ImplementationRegistry.h"
+#include "registry/DeletionQueue.h"
+#include "registry/NamePool.h"
 
 #include "implementations/AbstractBufferImplementation.h"
 #include "implementations/AbstractFramebufferImplementation.h"
@@ -25,10 +27,15 @@ GLuint createObject(CreateObjectsFunction function)
     return id;
 }
 
+bool enqueueDeletion(const globjects::DeletionQueue::Type type, const GLuint id)
+{
+    return globjects::DeletionQueue::current().enqueue(type, id);
+}
+
 template <typename DeleteObjectsFunction>
-void deleteObject(DeleteObjectsFunction function, const GLuint id, const bool hasOwnership)
+void deleteObject(DeleteObjectsFunction function, const globjects::DeletionQueue::Type type, const GLuint id, const bool hasOwnership)
 {
-    if (!hasOwnership)
+    if (!hasOwnership || enqueueDeletion(type, id))
     {
         return;
     }
@@ -111,13 +118,18 @@ InvalidResource::~InvalidResource()
 
 
 BufferResource::BufferResource()
-: IDResource(ImplementationRegistry::current().bufferImplementation().create())
+: IDResource(NamePool::current().buffer())
+{
+}
+
+BufferResource::BufferResource(const GLuint id)
+: IDResource(id)
 {
 }
 
 BufferResource::~BufferResource()
 {
-    if (hasOwnership())
+    if (hasOwnership() && !enqueueDeletion(DeletionQueue::Type::Buffer, id()))
         ImplementationRegistry::current().bufferImplementation().destroy(id());
 }
 
@@ -129,7 +141,7 @@ FrameBufferObjectResource::FrameBufferObjectResource()
 
 FrameBufferObjectResource::~FrameBufferObjectResource()
 {
-    if (hasOwnership())
+    if (hasOwnership() && !enqueueDeletion(DeletionQueue::Type::Framebuffer, id()))
         ImplementationRegistry::current().framebufferImplementation().destroy(id());
 }
 
@@ -141,7 +153,7 @@ ProgramResource::ProgramResource()
 
 ProgramResource::~ProgramResource()
 {
-    if (hasOwnership())
+    if (hasOwnership() && !enqueueDeletion(DeletionQueue::Type::Program, id()))
     {
         glDeleteProgram(id());
     }
@@ -155,7 +167,7 @@ ProgramPipelineResource::ProgramPipelineResource()
 
 ProgramPipelineResource::~ProgramPipelineResource()
 {
-    deleteObject(glDeleteProgramPipelines, id(), hasOwnership());
+    deleteObject(glDeleteProgramPipelines, DeletionQueue::Type::ProgramPipeline, id(), hasOwnership());
 }
 
 
@@ -164,9 +176,14 @@ QueryResource::QueryResource()
 {
 }
 
+QueryResource::QueryResource(const GLuint id)
+: IDResource(id)
+{
+}
+
 QueryResource::~QueryResource()
 {
-    deleteObject(glDeleteQueries, id(), hasOwnership());
+    deleteObject(glDeleteQueries, DeletionQueue::Type::Query, id(), hasOwnership());
 }
 
 
@@ -177,7 +194,7 @@ RenderBufferObjectResource::RenderBufferObjectResource()
 
 RenderBufferObjectResource::~RenderBufferObjectResource()
 {
-    deleteObject(glDeleteRenderbuffers, id(), hasOwnership());
+    deleteObject(glDeleteRenderbuffers, DeletionQueue::Type::Renderbuffer, id(), hasOwnership());
 }
 
 
@@ -188,7 +205,7 @@ SamplerResource::SamplerResource()
 
 SamplerResource::~SamplerResource()
 {
-    deleteObject(glDeleteSamplers, id(), hasOwnership());
+    deleteObject(glDeleteSamplers, DeletionQueue::Type::Sampler, id(), hasOwnership());
 }
 
 ShaderResource::ShaderResource(GLenum type)
@@ -198,7 +215,7 @@ ShaderResource::ShaderResource(GLenum type)
 
 ShaderResource::~ShaderResource()
 {
-    if (hasOwnership())
+    if (hasOwnership() && !enqueueDeletion(DeletionQueue::Type::Shader, id()))
     {
         glDeleteShader(id());
     }
@@ -206,13 +223,18 @@ ShaderResource::~ShaderResource()
 
 
 TextureResource::TextureResource(GLenum target)
-: IDResource(ImplementationRegistry::current().textureBindlessImplementation().create(target))
+: IDResource(NamePool::current().texture(target))
+{
+}
+
+TextureResource::TextureResource(const GLuint id)
+: IDResource(id)
 {
 }
 
 TextureResource::~TextureResource()
 {
-    if (hasOwnership())
+    if (hasOwnership() && !enqueueDeletion(DeletionQueue::Type::Texture, id()))
     {
         ImplementationRegistry::current().textureBindlessImplementation().destroy(id());
     }
@@ -226,7 +248,7 @@ TransformFeedbackResource::TransformFeedbackResource()
 
 TransformFeedbackResource::~TransformFeedbackResource()
 {
-    deleteObject(glDeleteTransformFeedbacks, id(), hasOwnership());
+    deleteObject(glDeleteTransformFeedbacks, DeletionQueue::Type::TransformFeedback, id(), hasOwnership());
 }
 
 
@@ -237,7 +259,7 @@ VertexArrayObjectResource::VertexArrayObjectResource()
 
 VertexArrayObjectResource::~VertexArrayObjectResource()
 {
-    deleteObject(glDeleteVertexArrays, id(), hasOwnership());
+    deleteObject(glDeleteVertexArrays, DeletionQueue::Type::VertexArray, id(), hasOwnership());
 }
 
 
@@ -0,0 +1,177 @@
+
+#include <globjects/StreamCompaction.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/PrefixScan.h>
+#include <globjects/Program.h>
+
+#include "ComputeKernel.h"
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+const GLuint groupSize = 256;
+
+
+const char * const evaluateSource = R"(
+layout (local_size_x = 256) in;
+
+layout (std430, binding = 0) readonly buffer Input { ELEMENT inputs[]; };
+layout (std430, binding = 1) writeonly buffer Flags { uint flags[]; };
+
+uniform uint count;
+
+bool predicate(ELEMENT value, uint index)
+{
+    return PREDICATE;
+}
+
+void main()
+{
+    uint index = groupIndex() * 256u + gl_LocalInvocationID.x;
+
+    if (index >= count)
+        return;
+
+    flags[index] = predicate(inputs[index], index) ? 1u : 0u;
+}
+)";
+
+const char * const scatterSource = R"(
+layout (local_size_x = 256) in;
+
+layout (std430, binding = 0) readonly buffer Input { ELEMENT inputs[]; };
+layout (std430, binding = 1) readonly buffer Flags { uint flags[]; };
+layout (std430, binding = 2) readonly buffer Offsets { uint offsets[]; };
+layout (std430, binding = 3) writeonly buffer Output { ELEMENT outputs[]; };
+layout (std430, binding = 4) writeonly buffer Count { uint selected; };
+
+uniform uint count;
+
+void main()
+{
+    uint index = groupIndex() * 256u + gl_LocalInvocationID.x;
+
+    if (index >= count)
+        return;
+
+    uint flag = flags[index];
+
+    if (flag != 0u)
+        outputs[offsets[index]] = inputs[index];
+
+    if (index == count - 1u)
+        selected = offsets[index] + flag;
+}
+)";
+
+
+std::string defines(const std::string & predicate, const std::string & elementType, const std::string & declarations)
+{
+    return declarations + "\n#define ELEMENT " + elementType + "\n#define PREDICATE (" + predicate + ")\n";
+}
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+StreamCompaction::StreamCompaction(const std::string & predicate, const std::string & elementType, const std::string & declarations)
+: m_evaluate(new ComputeKernel(defines(predicate, elementType, declarations), evaluateSource))
+, m_scatter(new ComputeKernel(defines(predicate, elementType, declarations), scatterSource))
+, m_scan(PrefixScan::create(PrefixScan::Type::UnsignedInt))
+, m_flags(Buffer::create())
+, m_offsets(Buffer::create())
+, m_count(Buffer::create())
+, m_capacity(0)
+{
+    const GLuint zero = 0;
+    m_count->setData(static_cast<GLsizeiptr>(sizeof(GLuint)), &zero, GL_DYNAMIC_COPY);
+}
+
+StreamCompaction::~StreamCompaction()
+{
+}
+
+void StreamCompaction::compact(const Buffer * input, Buffer * output, const GLuint count)
+{
+    assert(input != nullptr);
+    assert(output != nullptr);
+
+    if (count == 0)
+    {
+        const GLuint zero = 0;
+        m_count->setSubData(0, static_cast<GLsizeiptr>(sizeof(GLuint)), &zero);
+
+        return;
+    }
+
+    reserve(count);
+
+    const GLuint groups = (count + groupSize - 1) / groupSize;
+
+    input->bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+    m_flags->bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+
+    m_evaluate->program()->setUniform("count", count);
+    m_evaluate->dispatch(groups);
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    m_scan->scan(m_flags.get(), m_offsets.get(), count, PrefixScan::Mode::Exclusive);
+
+    input->bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+    m_flags->bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+    m_offsets->bindBase(GL_SHADER_STORAGE_BUFFER, 2);
+    output->bindBase(GL_SHADER_STORAGE_BUFFER, 3);
+    m_count->bindBase(GL_SHADER_STORAGE_BUFFER, 4);
+
+    m_scatter->program()->setUniform("count", count);
+    m_scatter->dispatch(groups);
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+}
+
+Buffer * StreamCompaction::countBuffer() const
+{
+    return m_count.get();
+}
+
+GLuint StreamCompaction::readCount() const
+{
+    GLuint count = 0;
+    m_count->getSubData(0, static_cast<GLsizeiptr>(sizeof(GLuint)), &count);
+
+    return count;
+}
+
+void StreamCompaction::reserve(const GLuint count)
+{
+    if (count <= m_capacity)
+    {
+        return;
+    }
+
+    m_capacity = std::max(count, m_capacity * 2);
+
+    m_flags->setData(static_cast<GLsizeiptr>(m_capacity) * static_cast<GLsizeiptr>(sizeof(GLuint)), nullptr, GL_DYNAMIC_COPY);
+    m_offsets->setData(static_cast<GLsizeiptr>(m_capacity) * static_cast<GLsizeiptr>(sizeof(GLuint)), nullptr, GL_DYNAMIC_COPY);
+}
+
+
+} // namespace globjects
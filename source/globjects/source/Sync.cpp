@@ -7,6 +7,7 @@
 #include <glbinding/gl/values.h>
 
 #include <globjects/DebugMessage.h>
+#include <globjects/AsyncPoller.h>
 
 
 using namespace gl;
@@ -59,6 +60,48 @@ GLsync Sync::sync() const
     return m_sync;
 }
 
+void Sync::renew(const GLenum condition)
+{
+    if (m_sync != nullptr)
+    {
+        glDeleteSync(m_sync);
+    }
+
+    m_sync = fenceSync(condition, GL_UNUSED_BIT);
+}
+
+bool Sync::isSignaled()
+{
+    return static_cast<GLenum>(get(GL_SYNC_STATUS)) == GL_SIGNALED;
+}
+
+AsyncResult<bool> Sync::signaledAsync()
+{
+    AsyncResult<bool> result;
+
+    AsyncPoller::current().add([this, result]() {
+        if (!isSignaled())
+        {
+            return false;
+        }
+
+        result.resolve(true);
+
+        return true;
+    });
+
+    return result;
+}
+
+bool Sync::await_ready()
+{
+    return isSignaled();
+}
+
+void Sync::await_resume() const
+{
+}
+
 GLenum Sync::clientWait(const SyncObjectMask flags, const GLuint64 timeout)
 {
     return glClientWaitSync(m_sync, flags, timeout);
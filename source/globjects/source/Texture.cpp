@@ -1,6 +1,8 @@
 
 #include <globjects/Texture.h>
 
+#include <cassert>
+
 #include <glbinding/gl/enum.h>
 #include <glbinding/gl/functions.h>
 #include <glbinding/gl/boolean.h>
@@ -8,12 +10,15 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <globjects/Buffer.h>
+#include <globjects/FramebufferCache.h>
+#include <globjects/Readback.h>
 #include <globjects/TextureHandle.h>
 
 #include "pixelformat.h"
 #include <globjects/Resource.h>
 
 #include "registry/ImplementationRegistry.h"
+#include "registry/BarrierTracker.h"
 #include "implementations/AbstractTextureImplementation.h"
 #include "implementations/AbstractTextureStorageImplementation.h"
 #include "implementations/AbstractTextureStorageMultisampleImplementation.h"
@@ -95,6 +100,11 @@ std::unique_ptr<Texture> Texture::fromId(const GLuint id, const GLenum target)
 
 Texture::~Texture()
 {
+    while (!m_framebufferCacheListeners.empty())
+    {
+        // calls deregisterListener
+        (*m_framebufferCacheListeners.begin())->evict(this);
+    }
 }
 
 std::unique_ptr<Texture> Texture::createDefault()
@@ -102,6 +112,28 @@ std::unique_ptr<Texture> Texture::createDefault()
     return createDefault(GL_TEXTURE_2D);
 }
 
+std::vector<std::unique_ptr<Texture>> Texture::createMany(const GLenum target, const GLsizei count)
+{
+    std::vector<std::unique_ptr<Texture>> textures;
+
+    if (count <= 0)
+    {
+        return textures;
+    }
+
+    std::vector<GLuint> ids(static_cast<std::size_t>(count));
+    bindlessImplementation().create(target, count, ids.data());
+
+    textures.reserve(ids.size());
+
+    for (const auto id : ids)
+    {
+        textures.push_back(std::unique_ptr<Texture>(new Texture(std::unique_ptr<IDResource>(new TextureResource(id)), target)));
+    }
+
+    return textures;
+}
+
 std::unique_ptr<Texture> Texture::createDefault(const GLenum target)
 {
     auto texture = Texture::create(target);
@@ -118,6 +150,8 @@ std::unique_ptr<Texture> Texture::createDefault(const GLenum target)
 void Texture::bind() const
 {
     glBindTexture(m_target, id());
+
+    BarrierTracker::current().bindTexture(id());
 }
 
 void Texture::unbind() const
@@ -128,6 +162,8 @@ void Texture::unbind() const
 void Texture::unbind(const GLenum target)
 {
     glBindTexture(target, 0);
+
+    BarrierTracker::current().bindTexture(0);
 }
 
 void Texture::bindActive(const GLenum texture) const
@@ -138,6 +174,8 @@ void Texture::bindActive(const GLenum texture) const
 void Texture::bindActive(unsigned int index) const
 {
     bindlessImplementation().bindActive(this, index);
+
+    BarrierTracker::current().bindTexture(index, id());
 }
 
 void Texture::unbindActive(const GLenum texture) const
@@ -148,6 +186,8 @@ void Texture::unbindActive(const GLenum texture) const
 void Texture::unbindActive(unsigned int index) const
 {
     bindlessImplementation().unbindActive(this, index);
+
+    BarrierTracker::current().bindTexture(index, 0);
 }
 
 GLenum Texture::target() const
@@ -187,6 +227,8 @@ GLint Texture::getLevelParameter(const GLint level, const GLenum pname) const
 
 void Texture::getImage(const GLint level, const GLenum format, const GLenum type, GLvoid * image) const
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bind();
 
     glGetTexImage(m_target, level, format, type, image);
@@ -208,6 +250,8 @@ std::vector<unsigned char> Texture::getImage(const GLint level, const GLenum for
 
 void Texture::getCompressedImage(const GLint lod, GLvoid * image) const
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bind();
 
     glGetCompressedTexImage(m_target, lod, image);
@@ -223,23 +267,74 @@ std::vector<unsigned char> Texture::getCompressedImage(const GLint lod) const
     return data;
 }
 
+AsyncResult<std::vector<unsigned char>> Texture::readAsync(const GLint level, const GLenum format, const GLenum type) const
+{
+    return Readback::toVector(readMappedAsync(level, format, type));
+}
+
+AsyncResult<bool> Texture::readAsync(const GLint level, const GLenum format, const GLenum type, GLvoid * image) const
+{
+    return Readback::copyTo(readMappedAsync(level, format, type), image);
+}
+
+AsyncResult<std::shared_ptr<const Readback>> Texture::readMappedAsync(const GLint level, const GLenum format, const GLenum type) const
+{
+    const GLint width = getLevelParameter(level, GL_TEXTURE_WIDTH);
+    const GLint height = getLevelParameter(level, GL_TEXTURE_HEIGHT);
+    const GLint depth = getLevelParameter(level, GL_TEXTURE_DEPTH);
+
+    const GLsizeiptr size = imageSizeInBytes(width, height, depth, format, type);
+
+    // shared, as std::function requires copyable captures
+    std::shared_ptr<Buffer> staging = Buffer::create();
+    staging->setData(size, nullptr, GL_STREAM_READ);
+
+    staging->bind(GL_PIXEL_PACK_BUFFER);
+    getImage(level, format, type, nullptr);
+    Buffer::unbind(GL_PIXEL_PACK_BUFFER);
+
+    return Readback::fenced(staging, size);
+}
+
+AsyncResult<std::vector<unsigned char>> Texture::readCompressedAsync(const GLint lod) const
+{
+    const GLsizeiptr size = getLevelParameter(lod, GL_TEXTURE_COMPRESSED_IMAGE_SIZE);
+
+    std::shared_ptr<Buffer> staging = Buffer::create();
+    staging->setData(size, nullptr, GL_STREAM_READ);
+
+    staging->bind(GL_PIXEL_PACK_BUFFER);
+    getCompressedImage(lod, nullptr);
+    Buffer::unbind(GL_PIXEL_PACK_BUFFER);
+
+    return Readback::toVector(Readback::fenced(staging, size));
+}
+
 void Texture::image1D(const GLint level, const GLenum internalFormat, const GLsizei width, const GLint border, const GLenum format, const GLenum type, const GLvoid * data)
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bindlessImplementation().image1D(this, level, internalFormat, width, border, format, type, data);
 }
 
 void Texture::compressedImage1D(const GLint level, const GLenum internalFormat, const GLsizei width, const GLint border, const GLsizei imageSize, const GLvoid * data)
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bindlessImplementation().compressedImage1D(this, level, internalFormat, width, border, imageSize, data);
 }
 
 void Texture::subImage1D(const GLint level, const GLint xOffset, const GLsizei width, const GLenum format, const GLenum type, const GLvoid * data)
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bindlessImplementation().subImage1D(this, level, xOffset, width, format, type, data);
 }
 
 void Texture::image2D(const GLint level, const GLenum internalFormat, const GLsizei width, const GLsizei height, const GLint border, const GLenum format, const GLenum type, const GLvoid* data)
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bindlessImplementation().image2D(this, level, internalFormat, width, height, border, format, type, data);
 }
 
@@ -250,6 +345,8 @@ void Texture::image2D(const GLint level, const GLenum internalFormat, const glm:
 
 void Texture::compressedImage2D(const GLint level, const GLenum internalFormat, const GLsizei width, const GLsizei height, const GLint border, const GLsizei imageSize, const GLvoid * data)
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bindlessImplementation().compressedImage2D(this, level, internalFormat, width, height, border, imageSize, data);
 }
 
@@ -260,6 +357,8 @@ void Texture::compressedImage2D(const GLint level, const GLenum internalFormat,
 
 void Texture::subImage2D(const GLint level, const GLint xOffset, const GLint yOffset, const GLsizei width, const GLsizei height, const GLenum format, const GLenum type, const GLvoid * data)
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bindlessImplementation().subImage2D(this, level, xOffset, yOffset, width, height, format, type, data);
 }
 
@@ -270,6 +369,8 @@ void Texture::subImage2D(const GLint level, const glm::ivec2& offset, const glm:
 
 void Texture::image3D(const GLint level, const GLenum internalFormat, const GLsizei width, const GLsizei height, const GLsizei depth, const GLint border, const GLenum format, const GLenum type, const GLvoid* data)
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bindlessImplementation().image3D(this, level, internalFormat, width, height, depth, border, format, type, data);
 }
 
@@ -280,6 +381,8 @@ void Texture::image3D(const GLint level, const GLenum internalFormat, const glm:
 
 void Texture::compressedImage3D(const GLint level, const GLenum internalFormat, const GLsizei width, const GLsizei height, const GLsizei depth, const GLint border, const GLsizei imageSize, const GLvoid * data)
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bindlessImplementation().compressedImage3D(this, level, internalFormat, width, height, depth, border, imageSize, data);
 }
 
@@ -290,6 +393,8 @@ void Texture::compressedImage3D(GLint level, GLenum internalFormat, const glm::i
 
 void Texture::subImage3D(const GLint level, const GLint xOffset, const GLint yOffset, const GLint zOffset, const GLsizei width, const GLsizei height, const GLsizei depth, const GLenum format, const GLenum type, const GLvoid * data)
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bindlessImplementation().subImage3D(this, level, xOffset, yOffset, zOffset, width, height, depth, format, type, data);
 }
 
@@ -380,6 +485,8 @@ void Texture::texBufferRange(const GLenum internalFormat, Buffer * buffer, const
 
 void Texture::clearImage(const GLint level, const GLenum format, const GLenum type, const void * data)
 {
+    BarrierTracker::current().textureUpdate(id());
+
     glClearTexImage(id(), level, format, type, data);
 }
 
@@ -400,6 +507,8 @@ void Texture::clearImage(const GLint level, const GLenum format, const GLenum ty
 
 void Texture::clearSubImage(const GLint level, const GLint xOffset, const GLint yOffset, const GLint zOffset, const GLsizei width, const GLsizei height, const GLsizei depth, const GLenum format, const GLenum type, const void * data)
 {
+    BarrierTracker::current().textureUpdate(id());
+
     glClearTexSubImage(id(), level, xOffset, yOffset, zOffset, width, height, depth, format, type, data);
 }
 
@@ -441,21 +550,29 @@ void Texture::invalidateSubImage(GLint level, const glm::ivec3& offset, const gl
 void Texture::bindImageTexture(const GLuint unit, const GLint level, const GLboolean layered, const GLint layer, const GLenum access, const GLenum format) const
 {
     glBindImageTexture(unit, id(), level, layered, layer, access, format);
+
+    BarrierTracker::current().bindImage(unit, id(), access);
 }
 
 void Texture::unbindImageTexture(const GLuint unit)
 {
     // the concrete parameters (except unit & texture) don't seem to matter, as long as their values are valid
     glBindImageTexture(unit, 0, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA8);
+
+    BarrierTracker::current().bindImage(unit, 0, GL_READ_ONLY);
 }
 
 void Texture::generateMipmap()
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bindlessImplementation().generateMipMap(this);
 }
 
 void Texture::cubeMapImage(gl::GLint level, gl::GLenum internalFormat, gl::GLsizei width, gl::GLsizei height, gl::GLint border, gl::GLenum format, gl::GLenum type, const gl::GLvoid * data)
 {
+    BarrierTracker::current().textureUpdate(id());
+
     bindlessImplementation().cubeMapImage(this, level, internalFormat, width, height, border, format, type, data);
 }
 
@@ -489,5 +606,19 @@ GLenum Texture::objectType() const
     return GL_TEXTURE;
 }
 
+void Texture::registerListener(FramebufferCache * listener)
+{
+    assert(listener != nullptr);
+
+    m_framebufferCacheListeners.insert(listener);
+}
+
+void Texture::deregisterListener(FramebufferCache * listener)
+{
+    assert(listener != nullptr);
+
+    m_framebufferCacheListeners.erase(listener);
+}
+
 
 } // namespace globjects
@@ -0,0 +1,378 @@
+
+#include <globjects/TexturePool.h>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/boolean.h>
+
+#include <globjects/FrameFenceManager.h>
+#include <globjects/Renderbuffer.h>
+#include <globjects/Texture.h>
+
+#include "pixelformat.h"
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+bool isMultisample(const GLenum target)
+{
+    return target == GL_TEXTURE_2D_MULTISAMPLE || target == GL_TEXTURE_2D_MULTISAMPLE_ARRAY;
+}
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+TexturePool::Description::Description()
+: Description(GL_TEXTURE_2D, GL_RGBA8, 1)
+{
+}
+
+TexturePool::Description::Description(const GLenum target, const GLenum internalFormat, const GLsizei width, const GLsizei height, const GLsizei depth, const GLsizei levels, const GLsizei samples)
+: target(target)
+, internalFormat(internalFormat)
+, width(width)
+, height(height)
+, depth(depth)
+, levels(levels)
+, samples(samples)
+{
+}
+
+bool TexturePool::Description::operator==(const Description & other) const
+{
+    return target == other.target
+        && internalFormat == other.internalFormat
+        && width == other.width
+        && height == other.height
+        && depth == other.depth
+        && levels == other.levels
+        && samples == other.samples;
+}
+
+std::size_t TexturePool::DescriptionHash::operator()(const Description & description) const
+{
+    std::size_t hash = std::hash<unsigned int>()(static_cast<unsigned int>(description.target));
+
+    for (const GLsizei value : { static_cast<GLsizei>(description.internalFormat), description.width, description.height, description.depth, description.levels, description.samples })
+    {
+        hash ^= std::hash<GLsizei>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+
+    return hash;
+}
+
+Object * TexturePool::Entry::object() const
+{
+    return texture ? static_cast<Object *>(texture.get()) : renderbuffer.get();
+}
+
+double TexturePool::Statistics::hitRate() const
+{
+    const std::uint64_t requests = hits + misses;
+
+    return requests > 0 ? static_cast<double>(hits) / static_cast<double>(requests) : 0.0;
+}
+
+TexturePool::TexturePool(FrameFenceManager * fences, const std::size_t budget)
+: m_fences(fences)
+, m_budget(budget)
+, m_availableBytes(0)
+, m_useCounter(0)
+, m_statistics(Statistics{ 0, 0, 0, 0, 0, 0 })
+{
+}
+
+TexturePool::~TexturePool()
+{
+}
+
+std::size_t TexturePool::budget() const
+{
+    return m_budget;
+}
+
+void TexturePool::setBudget(const std::size_t budget)
+{
+    m_budget = budget;
+
+    trim();
+}
+
+Texture * TexturePool::obtainTexture(const Description & description)
+{
+    assert(description.target != GL_RENDERBUFFER);
+
+    return static_cast<Texture *>(obtain(description));
+}
+
+Renderbuffer * TexturePool::obtainRenderbuffer(const GLenum internalFormat, const GLsizei width, const GLsizei height, const GLsizei samples)
+{
+    return static_cast<Renderbuffer *>(obtain(Description(GL_RENDERBUFFER, internalFormat, width, height, 1, 1, samples)));
+}
+
+void TexturePool::release(Texture * texture)
+{
+    release(static_cast<Object *>(texture));
+}
+
+void TexturePool::release(Renderbuffer * renderbuffer)
+{
+    release(static_cast<Object *>(renderbuffer));
+}
+
+Object * TexturePool::obtain(const Description & description)
+{
+    collect();
+
+    Entry entry{};
+
+    const auto it = m_available.find(description);
+
+    if (it != m_available.end() && !it->second.empty())
+    {
+        // the most recently released object is the most likely to be resident
+        entry = std::move(it->second.back());
+        it->second.pop_back();
+
+        m_availableBytes -= entry.bytes;
+        m_statistics.pooledBytes -= entry.bytes;
+        ++m_statistics.hits;
+    }
+    else
+    {
+        allocate(description, entry);
+        entry.description = description;
+        entry.bytes = sizeInBytes(description);
+
+        ++m_statistics.misses;
+    }
+
+    Object * object = entry.object();
+
+    m_statistics.inUseBytes += entry.bytes;
+    m_inUse[object] = std::move(entry);
+
+    updatePeak();
+
+    return object;
+}
+
+void TexturePool::release(Object * object)
+{
+    assert(object != nullptr);
+
+    const auto it = m_inUse.find(object);
+
+    if (it == m_inUse.end())
+    {
+        return;
+    }
+
+    Entry entry = std::move(it->second);
+    m_inUse.erase(it);
+
+    m_statistics.inUseBytes -= entry.bytes;
+    m_statistics.pooledBytes += entry.bytes;
+
+    entry.lastUse = ++m_useCounter;
+
+    if (m_fences)
+    {
+        entry.frame = m_fences->currentFrame();
+        m_pending.push_back(std::move(entry));
+
+        return;
+    }
+
+    makeAvailable(std::move(entry));
+}
+
+void TexturePool::collect()
+{
+    if (m_pending.empty())
+    {
+        return;
+    }
+
+    std::vector<Entry> pending;
+    pending.swap(m_pending);
+
+    for (auto & entry : pending)
+    {
+        if (m_fences->isComplete(entry.frame))
+        {
+            makeAvailable(std::move(entry));
+        }
+        else
+        {
+            m_pending.push_back(std::move(entry));
+        }
+    }
+}
+
+void TexturePool::clear()
+{
+    m_statistics.pooledBytes -= m_availableBytes;
+    m_availableBytes = 0;
+
+    m_available.clear();
+}
+
+std::size_t TexturePool::sizeInBytes(const Description & description)
+{
+    std::size_t size = 0;
+
+    GLsizei width = description.width;
+    GLsizei height = description.height;
+    GLsizei depth = description.depth;
+
+    // array layers and cube faces are not halved per level
+    const bool layered = description.target != GL_TEXTURE_3D;
+
+    for (GLsizei level = 0; level < std::max(description.levels, 1); ++level)
+    {
+        size += static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * static_cast<std::size_t>(depth);
+
+        width = std::max(width / 2, 1);
+        height = description.target == GL_TEXTURE_1D_ARRAY ? height : std::max(height / 2, 1);
+        depth = layered ? depth : std::max(depth / 2, 1);
+    }
+
+    if (description.target == GL_TEXTURE_CUBE_MAP)
+    {
+        size *= 6;
+    }
+
+    return size * static_cast<std::size_t>(bytesPerTexel(description.internalFormat)) * static_cast<std::size_t>(std::max(description.samples, 1));
+}
+
+const TexturePool::Statistics & TexturePool::statistics() const
+{
+    return m_statistics;
+}
+
+void TexturePool::resetStatistics()
+{
+    // pooled and in use bytes describe the current state and are kept
+    m_statistics.peakBytes = m_statistics.pooledBytes + m_statistics.inUseBytes;
+    m_statistics.hits = 0;
+    m_statistics.misses = 0;
+    m_statistics.evictions = 0;
+}
+
+void TexturePool::makeAvailable(Entry entry)
+{
+    m_availableBytes += entry.bytes;
+
+    m_available[entry.description].push_back(std::move(entry));
+
+    trim();
+}
+
+void TexturePool::trim()
+{
+    while (m_availableBytes > m_budget)
+    {
+        // entries are appended in release order, so the front of each list is its least recently used
+        auto oldest = m_available.end();
+
+        for (auto it = m_available.begin(); it != m_available.end(); ++it)
+        {
+            if (!it->second.empty() && (oldest == m_available.end() || it->second.front().lastUse < oldest->second.front().lastUse))
+            {
+                oldest = it;
+            }
+        }
+
+        if (oldest == m_available.end())
+        {
+            break;
+        }
+
+        const std::size_t bytes = oldest->second.front().bytes;
+
+        oldest->second.erase(oldest->second.begin());
+
+        if (oldest->second.empty())
+        {
+            m_available.erase(oldest);
+        }
+
+        m_availableBytes -= bytes;
+        m_statistics.pooledBytes -= bytes;
+        ++m_statistics.evictions;
+    }
+}
+
+void TexturePool::updatePeak()
+{
+    m_statistics.peakBytes = std::max(m_statistics.peakBytes, m_statistics.pooledBytes + m_statistics.inUseBytes);
+}
+
+void TexturePool::allocate(const Description & d, Entry & entry)
+{
+    if (d.target == GL_RENDERBUFFER)
+    {
+        auto renderbuffer = Renderbuffer::create();
+
+        if (d.samples > 0)
+        {
+            renderbuffer->storageMultisample(d.samples, d.internalFormat, d.width, d.height);
+        }
+        else
+        {
+            renderbuffer->storage(d.internalFormat, d.width, d.height);
+        }
+
+        entry.renderbuffer = std::move(renderbuffer);
+
+        return;
+    }
+
+    auto texture = isMultisample(d.target) ? Texture::create(d.target) : Texture::createDefault(d.target);
+
+    switch (d.target)
+    {
+    case GL_TEXTURE_1D:
+        texture->storage1D(d.levels, d.internalFormat, d.width);
+        break;
+
+    case GL_TEXTURE_2D_MULTISAMPLE:
+        texture->storage2DMultisample(d.samples, d.internalFormat, d.width, d.height, GL_TRUE);
+        break;
+
+    case GL_TEXTURE_2D_MULTISAMPLE_ARRAY:
+        texture->storage3DMultisample(d.samples, d.internalFormat, d.width, d.height, d.depth, GL_TRUE);
+        break;
+
+    case GL_TEXTURE_3D:
+    case GL_TEXTURE_2D_ARRAY:
+    case GL_TEXTURE_CUBE_MAP_ARRAY:
+        texture->storage3D(d.levels, d.internalFormat, d.width, d.height, d.depth);
+        break;
+
+    default:
+        texture->storage2D(d.levels, d.internalFormat, d.width, d.height);
+        break;
+    }
+
+    entry.texture = std::move(texture);
+}
+
+
+} // namespace globjects
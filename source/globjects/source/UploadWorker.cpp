@@ -0,0 +1,164 @@
+
+#include <globjects/UploadWorker.h>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/values.h>
+
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
+#include <globjects/Shader.h>
+#include <globjects/Sync.h>
+#include <globjects/Texture.h>
+
+#include "registry/Registry.h"
+
+
+using namespace gl;
+
+
+namespace globjects
+{
+
+
+UploadWorker::UploadWorker(const glbinding::ContextHandle contextHandle, const glbinding::GetProcAddress functionPointerResolver, const glbinding::ContextHandle sharedContextId, ContextCallback makeCurrent, ContextCallback doneCurrent)
+: m_contextHandle(contextHandle)
+, m_functionPointerResolver(functionPointerResolver)
+, m_sharedContextId(sharedContextId)
+, m_makeCurrent(std::move(makeCurrent))
+, m_doneCurrent(std::move(doneCurrent))
+, m_pending(0)
+, m_running(true)
+{
+    m_thread = std::thread(&UploadWorker::run, this);
+}
+
+UploadWorker::~UploadWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_running = false;
+    }
+
+    m_condition.notify_one();
+    m_thread.join();
+}
+
+void UploadWorker::uploadBuffer(std::vector<unsigned char> data, const GLenum usage, Callback<Buffer> callback)
+{
+    auto shared = std::make_shared<std::vector<unsigned char>>(std::move(data));
+
+    enqueue<Buffer>([shared, usage]() {
+        auto buffer = Buffer::create();
+        buffer->setData(static_cast<GLsizeiptr>(shared->size()), shared->data(), usage);
+
+        return buffer;
+    }, std::move(callback));
+}
+
+void UploadWorker::uploadTexture(const GLenum target, const GLenum internalFormat, const GLsizei width, const GLsizei height, const GLenum format, const GLenum type, std::vector<unsigned char> data, Callback<Texture> callback)
+{
+    auto shared = std::make_shared<std::vector<unsigned char>>(std::move(data));
+
+    enqueue<Texture>([shared, target, internalFormat, width, height, format, type]() {
+        auto texture = Texture::create(target);
+        texture->image2D(0, internalFormat, width, height, 0, format, type, shared->empty() ? nullptr : shared->data());
+
+        return texture;
+    }, std::move(callback));
+}
+
+void UploadWorker::compileShader(const GLenum type, AbstractStringSource * source, Callback<Shader> callback)
+{
+    enqueue<Shader>([type, source]() {
+        auto shader = Shader::create(type, source);
+        shader->compile();
+
+        return shader;
+    }, std::move(callback));
+}
+
+std::size_t UploadWorker::collect()
+{
+    std::vector<Task> finished;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        finished.swap(m_finished);
+        m_pending -= finished.size();
+    }
+
+    for (auto & task : finished)
+    {
+        // server-side wait, the render thread is not stalled
+        task.fence->wait(GL_TIMEOUT_IGNORED);
+        task.finish();
+    }
+
+    return finished.size();
+}
+
+std::size_t UploadWorker::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_pending;
+}
+
+void UploadWorker::submit(std::function<void()> work, std::function<void()> finish)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_queue.push_back(Task{ std::move(work), std::move(finish), nullptr });
+        ++m_pending;
+    }
+
+    m_condition.notify_one();
+}
+
+void UploadWorker::run()
+{
+    m_makeCurrent();
+
+    registerContext(m_contextHandle, m_functionPointerResolver, m_sharedContextId);
+
+    while (true)
+    {
+        Task task;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_condition.wait(lock, [this]() { return !m_running || !m_queue.empty(); });
+
+            if (m_queue.empty())
+            {
+                break;
+            }
+
+            task = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        task.work();
+
+        task.fence = Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE);
+
+        // the fence has to reach the server before another context can wait for it
+        glFlush();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_finished.push_back(std::move(task));
+    }
+
+    Registry::deregisterContext(m_contextHandle);
+
+    m_doneCurrent();
+}
+
+
+} // namespace globjects
@@ -1,19 +1,25 @@
 
 #include <globjects/VertexArray.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 
 #include <glbinding/gl/functions.h>
 #include <glbinding/gl/enum.h>
+#include <glbinding/Version.h>
 
+#include <globjects/globjects.h>
+#include <globjects/Buffer.h>
 #include <globjects/VertexAttributeBinding.h>
 
 #include "registry/ImplementationRegistry.h"
 #include "implementations/AbstractVertexAttributeBindingImplementation.h"
 
-#include "base/container_helpers.h"
 #include "registry/ObjectRegistry.h"
 
+#include "DrawCommands.h"
+
 #include <globjects/Resource.h>
 
 
@@ -29,6 +35,9 @@ globjects::AbstractVertexAttributeBindingImplementation & implementation()
     return globjects::ImplementationRegistry::current().attributeImplementation();
 }
 
+// the range based multi draws convert to structure-of-arrays on the stack, in chunks of this many draws
+const std::size_t multiDrawChunkSize = 256;
+
 
 } // namespace
 
@@ -39,6 +48,7 @@ namespace globjects
 
 VertexArray::VertexArray()
 : Object(std::unique_ptr<IDResource>(new VertexArrayObjectResource))
+, m_elementBuffer(nullptr)
 {
 #ifdef GLOBJECTS_CHECK_GL_ERRORS
     if (id() == 0 && !m_resource->isExternal())
@@ -56,6 +66,7 @@ VertexArray::VertexArray()
 
 VertexArray::VertexArray(std::unique_ptr<IDResource> && resource)
 : Object(std::move(resource))
+, m_elementBuffer(nullptr)
 {
 }
 
@@ -117,6 +128,8 @@ const VertexAttributeBinding* VertexArray::binding(const GLuint bindingIndex) co
 void VertexArray::bindElementBuffer(const Buffer *buffer)
 {
     implementation().bindElementBuffer(this, buffer);
+
+    m_elementBuffer = buffer;
 }
 
 void VertexArray::enable(GLint attributeIndex)
@@ -155,19 +168,19 @@ std::vector<const VertexAttributeBinding*> VertexArray::bindings() const
 
 void VertexArray::drawArrays(const GLenum mode, const GLint first, const GLsizei count) const
 {
-    bind();
+    prepareDraw();
     glDrawArrays(mode, first, count);
 }
 
 void VertexArray::drawArraysInstanced(const GLenum mode, const GLint first, const GLsizei count, const GLsizei instanceCount) const
 {
-    bind();
+    prepareDraw();
     glDrawArraysInstanced(mode, first, count, instanceCount);
 }
 
 void VertexArray::drawArraysInstancedBaseInstance(const GLenum mode, const GLint first, const GLsizei count, const GLsizei instanceCount, const GLuint baseInstance) const
 {
-    bind();
+    prepareDraw();
     glDrawArraysInstancedBaseInstance(mode, first, count, instanceCount, baseInstance);
 }
 
@@ -175,111 +188,195 @@ void VertexArray::drawArraysIndirect(const GLenum mode, const void* indirect) co
 {
     // Don't assert a non-null indirect pointer as it may be a zero offset into the indirection buffer in GPU memory
     
-    bind();
+    prepareDraw();
     glDrawArraysIndirect(mode, indirect);
 }
 
 void VertexArray::multiDrawArrays(const GLenum mode, GLint* first, const GLsizei* count, const GLsizei drawCount) const
 {
-    bind();
-    glMultiDrawArrays(mode, first, count, drawCount);
+    multiDrawArrays(mode, static_cast<const GLint *>(first), count, drawCount);
 }
 
 void VertexArray::multiDrawArraysIndirect(const GLenum mode, const void* indirect, const GLsizei drawCount, const GLsizei stride) const
 {
-    bind();
+    prepareDraw();
     glMultiDrawArraysIndirect(mode, indirect, drawCount, stride);
 }
 
+void VertexArray::multiDrawArraysIndirectCount(const GLenum mode, const void* indirect, const GLintptr drawCount, const GLsizei maxDrawCount, const GLsizei stride) const
+{
+    prepareDraw();
+
+    if (version() >= glbinding::Version(4, 6))
+    {
+        glMultiDrawArraysIndirectCount(mode, indirect, drawCount, maxDrawCount, stride);
+    }
+    else
+    {
+        glMultiDrawArraysIndirectCountARB(mode, indirect, drawCount, maxDrawCount, stride);
+    }
+}
+
 void VertexArray::drawElements(const GLenum mode, const GLsizei count, const GLenum type, const void * indices) const
 {
-    bind();
+    prepareDraw();
     glDrawElements(mode, count, type, indices);
 }
 
 void VertexArray::drawElementsBaseVertex(const GLenum mode, const GLsizei count, const GLenum type, const void* indices, const GLint baseVertex) const
 {
-    bind();
+    prepareDraw();
     glDrawElementsBaseVertex(mode, count, type, const_cast<void*>(indices), baseVertex);
 }
 
 void VertexArray::drawElementsInstanced(const GLenum mode, const GLsizei count, const GLenum type, const void* indices, const GLsizei primitiveCount) const
 {
-    bind();
+    prepareDraw();
     glDrawElementsInstanced(mode, count, type, indices, primitiveCount);
 }
 
 void VertexArray::drawElementsInstancedBaseInstance(const GLenum mode, const GLsizei count, const GLenum type, const void* indices, const GLsizei instanceCount, const GLuint baseInstance) const
 {
-    bind();
+    prepareDraw();
     glDrawElementsInstancedBaseInstance(mode, count, type, indices, instanceCount, baseInstance);
 }
 
 void VertexArray::drawElementsInstancedBaseVertex(const GLenum mode, const GLsizei count, const GLenum type, const void* indices, const GLsizei instanceCount, const GLint baseVertex) const
 {
-    bind();
+    prepareDraw();
     glDrawElementsInstancedBaseVertex(mode, count, type, indices, instanceCount, baseVertex);
 }
 
 void VertexArray::drawElementsInstancedBaseVertexBaseInstance(const GLenum mode, const GLsizei count, const GLenum type, const void* indices, const GLsizei instanceCount, const GLint baseVertex, const GLuint baseInstance) const
 {
-    bind();
+    prepareDraw();
     glDrawElementsInstancedBaseVertexBaseInstance(mode, count, type, indices, instanceCount, baseVertex, baseInstance);
 }
 
 void VertexArray::multiDrawElements(const GLenum mode, const GLsizei* count, const GLenum type, const void** indices, const GLsizei drawCount) const
 {
-    bind();
-    glMultiDrawElements(mode, count, type, indices, drawCount);
+    multiDrawElements(mode, type, count, indices, drawCount);
 }
 
 void VertexArray::multiDrawElementsBaseVertex(const GLenum mode, const GLsizei* count, const GLenum type, const void** indices, const GLsizei drawCount, GLint* baseVertex) const
 {
-    bind();
-    glMultiDrawElementsBaseVertex(mode, const_cast<GLsizei*>(count), type, const_cast<void**>(indices), drawCount, baseVertex);
+    multiDrawElementsBaseVertex(mode, type, count, indices, baseVertex, drawCount);
 }
 
 void VertexArray::multiDrawElementsIndirect(const GLenum mode, const GLenum type, const void* indirect, const GLsizei drawCount, const GLsizei stride) const
 {
-    bind();
+    prepareDraw();
     glMultiDrawElementsIndirect(mode, type, indirect, drawCount, stride);
 }
 
+void VertexArray::multiDrawElementsIndirectCount(const GLenum mode, const GLenum type, const void* indirect, const GLintptr drawCount, const GLsizei maxDrawCount, const GLsizei stride) const
+{
+    prepareDraw();
+
+    if (version() >= glbinding::Version(4, 6))
+    {
+        glMultiDrawElementsIndirectCount(mode, type, indirect, drawCount, maxDrawCount, stride);
+    }
+    else
+    {
+        glMultiDrawElementsIndirectCountARB(mode, type, indirect, drawCount, maxDrawCount, stride);
+    }
+}
+
 void VertexArray::drawRangeElements(const GLenum mode, const GLuint start, const GLuint end, const GLsizei count, const GLenum type, const void* indices) const
 {
-    bind();
+    prepareDraw();
     glDrawRangeElements(mode, start, end, count, type, indices);
 }
 
 void VertexArray::drawRangeElementsBaseVertex(const GLenum mode, const GLuint start, const GLuint end, const GLsizei count, const GLenum type, const void* indices, const GLint baseVertex) const
 {
-    bind();
+    prepareDraw();
     glDrawRangeElementsBaseVertex(mode, start, end, count, type, const_cast<void*>(indices), baseVertex);
 }
 
 void VertexArray::multiDrawArrays(const GLenum mode, const std::vector<VertexArray::MultiDrawArraysRange> & ranges) const
 {
-    std::vector<GLint> firsts = collect_member(ranges, &MultiDrawArraysRange::first);
-    std::vector<GLsizei> counts = collect_member(ranges, &MultiDrawArraysRange::count);
+    std::array<GLint, multiDrawChunkSize> firsts;
+    std::array<GLsizei, multiDrawChunkSize> counts;
+
+    for (std::size_t offset = 0; offset < ranges.size(); offset += multiDrawChunkSize)
+    {
+        const std::size_t size = std::min(ranges.size() - offset, multiDrawChunkSize);
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            firsts[i] = ranges[offset + i].first;
+            counts[i] = ranges[offset + i].count;
+        }
 
-    multiDrawArrays(mode, firsts.data(), counts.data(), static_cast<GLsizei>(ranges.size()));
+        multiDrawArrays(mode, static_cast<const GLint *>(firsts.data()), counts.data(), static_cast<GLsizei>(size));
+    }
 }
 
 void VertexArray::multiDrawElements(const GLenum mode, const GLenum type, const std::vector<VertexArray::MultiDrawElementsRange> & ranges) const
 {
-    std::vector<GLsizei> counts = collect_member(ranges, &MultiDrawElementsRange::count);
-    std::vector<const void*> indices = collect_type_member<const void*>(ranges, &MultiDrawElementsRange::indices);
+    std::array<GLsizei, multiDrawChunkSize> counts;
+    std::array<const void *, multiDrawChunkSize> indices;
+
+    for (std::size_t offset = 0; offset < ranges.size(); offset += multiDrawChunkSize)
+    {
+        const std::size_t size = std::min(ranges.size() - offset, multiDrawChunkSize);
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            counts[i] = ranges[offset + i].count;
+            indices[i] = ranges[offset + i].indices;
+        }
 
-    multiDrawElements(mode, counts.data(), type, indices.data(), static_cast<GLsizei>(ranges.size()));
+        multiDrawElements(mode, type, counts.data(), indices.data(), static_cast<GLsizei>(size));
+    }
 }
 
 void VertexArray::multiDrawElementsBaseVertex(const GLenum mode, const GLenum type, const std::vector<VertexArray::MultiDrawElementsBaseVertexRange> & ranges) const
 {
-    std::vector<GLsizei> counts = collect_member(ranges, &MultiDrawElementsBaseVertexRange::count);
-    std::vector<const void*> indices = collect_type_member<const void*>(ranges, &MultiDrawElementsBaseVertexRange::indices);
-    std::vector<GLint> baseVertices = collect_member(ranges, &MultiDrawElementsBaseVertexRange::baseVertex);
+    std::array<GLsizei, multiDrawChunkSize> counts;
+    std::array<const void *, multiDrawChunkSize> indices;
+    std::array<GLint, multiDrawChunkSize> baseVertices;
+
+    for (std::size_t offset = 0; offset < ranges.size(); offset += multiDrawChunkSize)
+    {
+        const std::size_t size = std::min(ranges.size() - offset, multiDrawChunkSize);
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            counts[i] = ranges[offset + i].count;
+            indices[i] = ranges[offset + i].indices;
+            baseVertices[i] = ranges[offset + i].baseVertex;
+        }
+
+        multiDrawElementsBaseVertex(mode, type, counts.data(), indices.data(), baseVertices.data(), static_cast<GLsizei>(size));
+    }
+}
+
+void VertexArray::multiDrawArrays(const GLenum mode, const GLint * firsts, const GLsizei * counts, const GLsizei drawCount) const
+{
+    prepareDraw();
+    glMultiDrawArrays(mode, firsts, counts, drawCount);
+}
+
+void VertexArray::multiDrawElements(const GLenum mode, const GLenum type, const GLsizei * counts, const void * const * indices, const GLsizei drawCount) const
+{
+    prepareDraw();
+    glMultiDrawElements(mode, counts, type, indices, drawCount);
+}
+
+void VertexArray::multiDrawElementsBaseVertex(const GLenum mode, const GLenum type, const GLsizei * counts, const void * const * indices, const GLint * baseVertices, const GLsizei drawCount) const
+{
+    prepareDraw();
+    glMultiDrawElementsBaseVertex(mode, const_cast<GLsizei *>(counts), type, const_cast<void **>(indices), drawCount, const_cast<GLint *>(baseVertices));
+}
+
+void VertexArray::prepareDraw() const
+{
+    bind();
 
-    multiDrawElementsBaseVertex(mode, counts.data(), type, indices.data(), static_cast<GLsizei>(ranges.size()), baseVertices.data());
+    DrawCommands::prepare(this);
 }
 
 GLenum VertexArray::objectType() const
@@ -15,13 +15,13 @@ template <typename T, class InputIterator, class Function>
 std::vector<T> collect(InputIterator first, InputIterator last, Function mapper);
 
 template <typename T, class Container, class Function>
-std::vector<T> collect(Container container, Function mapper);
+std::vector<T> collect(const Container & container, Function mapper);
 
 template<class Container, class Class, class MemberType>
-std::vector<MemberType> collect_member(Container container, MemberType Class::*memberPointer);
+std::vector<MemberType> collect_member(const Container & container, MemberType Class::*memberPointer);
 
 template<class ReturnType, class Container, class Class, class MemberType>
-std::vector<ReturnType> collect_type_member(Container container, MemberType Class::*memberPointer);
+std::vector<ReturnType> collect_type_member(const Container & container, MemberType Class::*memberPointer);
 
 
 } // namespace globjects
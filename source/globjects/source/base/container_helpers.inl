@@ -20,19 +20,19 @@ std::vector<T> collect(InputIterator first, InputIterator last, Function mapper)
 }
 
 template <typename T, class Container, class Function>
-std::vector<T> collect(Container container, Function mapper)
+std::vector<T> collect(const Container & container, Function mapper)
 {
     return collect<T, typename Container::const_iterator, Function>(container.begin(), container.end(), mapper);
 }
 
 template<class Container, class Class, class MemberType>
-std::vector<MemberType> collect_member(Container container, MemberType Class::*memberPointer)
+std::vector<MemberType> collect_member(const Container & container, MemberType Class::*memberPointer)
 {
     return collect<MemberType>(container, [memberPointer](const Class & object) { return (object.*memberPointer); });
 }
 
 template<class ReturnType, class Container, class Class, class MemberType>
-std::vector<ReturnType> collect_type_member(Container container, MemberType Class::*memberPointer)
+std::vector<ReturnType> collect_type_member(const Container & container, MemberType Class::*memberPointer)
 {
     return collect<ReturnType>(container, [memberPointer](const Class & object) { return static_cast<ReturnType>(object.*memberPointer); });
 }
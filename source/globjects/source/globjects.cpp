@@ -17,11 +17,15 @@
 #include <globjects/logging.h>
 #include <globjects/DebugMessage.h>
 #include <globjects/NamedString.h>
+#include <globjects/AsyncPoller.h>
 
 #include "registry/Registry.h"
 #include "registry/ObjectRegistry.h"
 #include "registry/ExtensionRegistry.h"
 #include "registry/ImplementationRegistry.h"
+#include "registry/DeletionQueue.h"
+#include "registry/NamePool.h"
+#include "registry/BarrierTracker.h"
 
 
 using namespace gl;
@@ -146,8 +150,47 @@ void init(glbinding::ContextHandle contextHandle, glbinding::GetProcAddress func
 
 void detachAllObjects()
 {
-    for (Object * object : Registry::current().objects().objects())
-        object->detach();
+    Registry::current().objects().detachAll();
+}
+
+std::size_t pollAsync()
+{
+    return AsyncPoller::current().poll();
+}
+
+void setDeferredDeletion(const bool enabled)
+{
+    DeletionQueue::current().setEnabled(enabled);
+}
+
+bool deferredDeletion()
+{
+    return DeletionQueue::current().isEnabled();
+}
+
+std::size_t flushDeletions()
+{
+    return DeletionQueue::current().flush();
+}
+
+std::size_t flushDeletionsFenced()
+{
+    return DeletionQueue::current().flushFenced();
+}
+
+void setNamePoolBatchSize(const GLsizei batchSize)
+{
+    NamePool::current().setBatchSize(batchSize);
+}
+
+void setBarrierTracking(const bool enabled)
+{
+    BarrierTracker::current().setEnabled(enabled);
+}
+
+bool barrierTracking()
+{
+    return BarrierTracker::current().isEnabled();
 }
 
 void registerCurrentContext(glbinding::GetProcAddress functionPointerResolver)
@@ -174,7 +217,15 @@ void registerContext(glbinding::ContextHandle contextHandle, glbinding::GetProcA
 
 void setContext(const glbinding::ContextHandle contextId)
 {
+    // glbinding may be bound to another context than globjects, e.g., after registerContext()
     glbinding::Binding::useContext(contextId);
+
+    // lock-free check, switching to the registry that is already current is a no-op
+    if (Registry::isCurrentContext(contextId))
+    {
+        return;
+    }
+
     Registry::setCurrentContext(contextId);
 }
 
@@ -24,6 +24,7 @@ public:
         Buffer::BindlessImplementation::DirectStateAccessARB);
 
     virtual gl::GLuint create() const = 0;
+    virtual void create(gl::GLsizei count, gl::GLuint * ids) const = 0;
     virtual void destroy(gl::GLuint id) const = 0;
 
     virtual void * map(const Buffer * buffer, gl::GLenum access) const = 0;
@@ -45,6 +45,9 @@ public:
     virtual void clearBufferfv(const Framebuffer * fbo, gl::GLenum buffer, gl::GLint drawBuffer, const gl::GLfloat * value) const = 0;
     virtual void clearBufferfi(const Framebuffer * fbo, gl::GLenum buffer, gl::GLint drawBuffer, gl::GLfloat depth, gl::GLint stencil) const = 0;
 
+    virtual void invalidate(const Framebuffer * fbo, gl::GLsizei numAttachments, const gl::GLenum * attachments) const = 0;
+    virtual void invalidateSubData(const Framebuffer * fbo, gl::GLsizei numAttachments, const gl::GLenum * attachments, gl::GLint x, gl::GLint y, gl::GLsizei width, gl::GLsizei height) const = 0;
+
     virtual void readPixels(const Framebuffer * fbo, const gl::GLint x, const gl::GLint y, const gl::GLsizei width, const gl::GLsizei height, const gl::GLenum format, const gl::GLenum type, gl::GLvoid * data) const = 0;
 
     virtual void blit(const Framebuffer * sourceFbo, const Framebuffer * targetFbo, gl::GLint srcX0, gl::GLint srcY0, gl::GLint srcX1, gl::GLint srcY1, gl::GLint destX0, gl::GLint destY0, gl::GLint destX1, gl::GLint destY1, gl::ClearBufferMask mask, gl::GLenum filter) const = 0;
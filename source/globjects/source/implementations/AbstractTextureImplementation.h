@@ -20,6 +20,7 @@ public:
         Texture::BindlessImplementation::DirectStateAccessARB);
 
     virtual gl::GLuint create(gl::GLenum target) const = 0;
+    virtual void create(gl::GLenum target, gl::GLsizei count, gl::GLuint * ids) const = 0;
     virtual void destroy(gl::GLuint id) const = 0;
 
     virtual void bindActive(const Texture * texture, gl::GLuint unit) const = 0;
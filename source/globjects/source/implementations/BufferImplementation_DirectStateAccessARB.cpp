@@ -24,6 +24,11 @@ GLuint BufferImplementation_DirectStateAccessARB::create() const
     return buffer;
 }
 
+void BufferImplementation_DirectStateAccessARB::create(const GLsizei count, GLuint * ids) const
+{
+    glCreateBuffers(count, ids);
+}
+
 void BufferImplementation_DirectStateAccessARB::destroy(const GLuint id) const
 {
     BufferImplementation_Legacy::instance()->destroy(id);
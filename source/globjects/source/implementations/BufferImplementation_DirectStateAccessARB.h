@@ -19,6 +19,7 @@ class BufferImplementation_DirectStateAccessARB : public AbstractBufferImplement
 {
 public:
     virtual gl::GLuint create() const override;
+    virtual void create(gl::GLsizei count, gl::GLuint * ids) const override;
     virtual void destroy(gl::GLuint id) const override;
 
     virtual void * map(const Buffer * buffer, gl::GLenum access) const override;
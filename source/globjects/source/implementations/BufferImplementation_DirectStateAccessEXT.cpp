@@ -21,6 +21,11 @@ GLuint BufferImplementation_DirectStateAccessEXT::create() const
     return BufferImplementation_Legacy::instance()->create();
 }
 
+void BufferImplementation_DirectStateAccessEXT::create(const GLsizei count, GLuint * ids) const
+{
+    BufferImplementation_Legacy::instance()->create(count, ids);
+}
+
 void BufferImplementation_DirectStateAccessEXT::destroy(const GLuint id) const
 {
     BufferImplementation_Legacy::instance()->destroy(id);
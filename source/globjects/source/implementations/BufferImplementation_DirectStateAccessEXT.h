@@ -18,6 +18,7 @@ class BufferImplementation_DirectStateAccessEXT : public AbstractBufferImplement
 {
 public:
     virtual gl::GLuint create() const override;
+    virtual void create(gl::GLsizei count, gl::GLuint * ids) const override;
     virtual void destroy(gl::GLuint id) const override;
 
     virtual void * map(const Buffer * buffer, gl::GLenum access) const override;
@@ -27,6 +27,16 @@ GLuint BufferImplementation_Legacy::create() const
     return buffer;
 }
 
+void BufferImplementation_Legacy::create(const GLsizei count, GLuint * ids) const
+{
+    glGenBuffers(count, ids);
+
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        glBindBuffer(s_workingTarget, ids[i]); // trigger actual buffer creation
+    }
+}
+
 void BufferImplementation_Legacy::destroy(const GLuint id) const
 {
     glDeleteBuffers(1, &id);
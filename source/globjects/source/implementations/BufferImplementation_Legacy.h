@@ -16,6 +16,7 @@ class BufferImplementation_Legacy : public AbstractBufferImplementation
 {
 public:
     virtual gl::GLuint create() const override;
+    virtual void create(gl::GLsizei count, gl::GLuint * ids) const override;
     virtual void destroy(gl::GLuint id) const override;
 
     virtual void * map(const Buffer * buffer, gl::GLenum access) const override;
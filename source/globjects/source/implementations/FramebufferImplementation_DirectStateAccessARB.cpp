@@ -124,6 +124,16 @@ void FramebufferImplementation_DirectStateAccessARB::clearBufferfi(const Framebu
     glClearNamedFramebufferfi(fbo->id(),buffer, drawBuffer, depth, stencil);
 }
 
+void FramebufferImplementation_DirectStateAccessARB::invalidate(const Framebuffer *fbo, const GLsizei numAttachments, const GLenum * attachments) const
+{
+    glInvalidateNamedFramebufferData(fbo->id(), numAttachments, attachments);
+}
+
+void FramebufferImplementation_DirectStateAccessARB::invalidateSubData(const Framebuffer *fbo, const GLsizei numAttachments, const GLenum * attachments, const GLint x, const GLint y, const GLsizei width, const GLsizei height) const
+{
+    glInvalidateNamedFramebufferSubData(fbo->id(), numAttachments, attachments, x, y, width, height);
+}
+
 void FramebufferImplementation_DirectStateAccessARB::readPixels(const Framebuffer *fbo, const GLint x, const GLint y, const GLsizei width, const GLsizei height, const GLenum format, const GLenum type, GLvoid * data) const
 {
     fbo->bind(GL_READ_FRAMEBUFFER);
@@ -129,6 +129,20 @@ void FramebufferImplementation_DirectStateAccessEXT::clearBufferfi(const Framebu
     glClearBufferfi(buffer, drawBuffer, depth, stencil);
 }
 
+void FramebufferImplementation_DirectStateAccessEXT::invalidate(const Framebuffer *fbo, const GLsizei numAttachments, const GLenum * attachments) const
+{
+    fbo->bind(GL_DRAW_FRAMEBUFFER);
+
+    glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, numAttachments, attachments);
+}
+
+void FramebufferImplementation_DirectStateAccessEXT::invalidateSubData(const Framebuffer *fbo, const GLsizei numAttachments, const GLenum * attachments, const GLint x, const GLint y, const GLsizei width, const GLsizei height) const
+{
+    fbo->bind(GL_DRAW_FRAMEBUFFER);
+
+    glInvalidateSubFramebuffer(GL_DRAW_FRAMEBUFFER, numAttachments, attachments, x, y, width, height);
+}
+
 void FramebufferImplementation_DirectStateAccessEXT::readPixels(const Framebuffer *fbo, const GLint x, const GLint y, const GLsizei width, const GLsizei height, const GLenum format, const GLenum type, GLvoid * data) const
 {
     fbo->bind(GL_READ_FRAMEBUFFER);
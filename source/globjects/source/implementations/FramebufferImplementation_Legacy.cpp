@@ -169,6 +169,20 @@ void FramebufferImplementation_Legacy::clearBufferfi(const Framebuffer *fbo, con
     glClearBufferfi(buffer, drawBuffer, depth, stencil);
 }
 
+void FramebufferImplementation_Legacy::invalidate(const Framebuffer *fbo, const GLsizei numAttachments, const GLenum * attachments) const
+{
+    fbo->bind(GL_DRAW_FRAMEBUFFER);
+
+    glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, numAttachments, attachments);
+}
+
+void FramebufferImplementation_Legacy::invalidateSubData(const Framebuffer *fbo, const GLsizei numAttachments, const GLenum * attachments, const GLint x, const GLint y, const GLsizei width, const GLsizei height) const
+{
+    fbo->bind(GL_DRAW_FRAMEBUFFER);
+
+    glInvalidateSubFramebuffer(GL_DRAW_FRAMEBUFFER, numAttachments, attachments, x, y, width, height);
+}
+
 void FramebufferImplementation_Legacy::readPixels(const Framebuffer *fbo, const GLint x, const GLint y, const GLsizei width, const GLsizei height, const GLenum format, const GLenum type, GLvoid * data) const
 {
     fbo->bind(GL_READ_FRAMEBUFFER);
@@ -35,6 +35,11 @@ gl::GLuint TextureImplementation_DirectStateAccessARB::create(gl::GLenum target)
     return result;
 }
 
+void TextureImplementation_DirectStateAccessARB::create(gl::GLenum target, gl::GLsizei count, gl::GLuint * ids) const
+{
+    gl::glCreateTextures(target, count, ids);
+}
+
 void TextureImplementation_DirectStateAccessARB::destroy(gl::GLuint id) const
 {
     get(Texture::BindlessImplementation::Legacy)->destroy(id);
@@ -30,6 +30,11 @@ gl::GLuint TextureImplementation_DirectStateAccessEXT::create(GLenum target) con
     return TextureImplementation_Legacy::instance()->create(target);
 }
 
+void TextureImplementation_DirectStateAccessEXT::create(GLenum target, GLsizei count, GLuint * ids) const
+{
+    TextureImplementation_Legacy::instance()->create(target, count, ids);
+}
+
 void TextureImplementation_DirectStateAccessEXT::destroy(gl::GLuint id) const
 {
     TextureImplementation_Legacy::instance()->destroy(id);
@@ -31,6 +31,16 @@ gl::GLuint TextureImplementation_Legacy::create(gl::GLenum target) const
     return result;
 }
 
+void TextureImplementation_Legacy::create(gl::GLenum target, gl::GLsizei count, gl::GLuint * ids) const
+{
+    gl::glGenTextures(count, ids);
+
+    for (gl::GLsizei i = 0; i < count; ++i)
+    {
+        gl::glBindTexture(target, ids[i]);
+    }
+}
+
 void TextureImplementation_Legacy::destroy(gl::GLuint id) const
 {
     gl::glDeleteTextures(1, &id);
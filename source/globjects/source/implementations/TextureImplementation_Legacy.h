@@ -19,6 +19,7 @@ public:
     virtual ~TextureImplementation_Legacy();
 
     virtual gl::GLuint create(gl::GLenum target) const override;
+    virtual void create(gl::GLenum target, gl::GLsizei count, gl::GLuint * ids) const override;
     virtual void destroy(gl::GLuint id) const override;
 
     virtual void bindActive(const Texture * texture, gl::GLuint unit) const override;
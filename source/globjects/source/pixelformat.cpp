@@ -149,4 +149,59 @@ int imageSizeInBytes(const int width, const int height, const int depth, const G
 }
 
 
+int bytesPerTexel(const GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+        case GL_R8:
+        case GL_R8_SNORM:
+        case GL_R8I:
+        case GL_R8UI:
+        case GL_STENCIL_INDEX8:
+            return 1;
+
+        case GL_R16:
+        case GL_R16F:
+        case GL_R16I:
+        case GL_R16UI:
+        case GL_RG8:
+        case GL_RG8I:
+        case GL_RG8UI:
+        case GL_DEPTH_COMPONENT16:
+            return 2;
+
+        case GL_RGB8:
+        case GL_SRGB8:
+            return 3;
+
+        case GL_RGB16F:
+        case GL_RGB16:
+            return 6;
+
+        case GL_RG32F:
+        case GL_RG32I:
+        case GL_RG32UI:
+        case GL_RGBA16:
+        case GL_RGBA16F:
+        case GL_RGBA16I:
+        case GL_RGBA16UI:
+        case GL_DEPTH32F_STENCIL8:
+            return 8;
+
+        case GL_RGB32F:
+        case GL_RGB32I:
+        case GL_RGB32UI:
+            return 12;
+
+        case GL_RGBA32F:
+        case GL_RGBA32I:
+        case GL_RGBA32UI:
+            return 16;
+
+        default:
+            return 4; // e.g., GL_RGBA8, GL_R32F, GL_RG16F, GL_R11F_G11F_B10F, GL_DEPTH_COMPONENT24 (padded)
+    }
+}
+
+
 } // namespace globjects
@@ -11,5 +11,8 @@ namespace globjects
 
 int imageSizeInBytes(int width, int height, int depth, gl::GLenum format, gl::GLenum type);
 
+// approximate storage size of a texel in a sized internal format, e.g., for memory budgets; 4 for unknown formats
+int bytesPerTexel(gl::GLenum internalFormat);
+
 
 } // namespace globjects
@@ -0,0 +1,316 @@
+
+#include "BarrierTracker.h"
+
+#include <initializer_list>
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+
+#include <globjects/globjects.h>
+
+#include "Registry.h"
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+// bits of all reading paths that are tracked; other bits would never be cleared
+unsigned int trackedBits()
+{
+    return static_cast<unsigned int>(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT)
+        | static_cast<unsigned int>(GL_ELEMENT_ARRAY_BARRIER_BIT)
+        | static_cast<unsigned int>(GL_UNIFORM_BARRIER_BIT)
+        | static_cast<unsigned int>(GL_TEXTURE_FETCH_BARRIER_BIT)
+        | static_cast<unsigned int>(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT)
+        | static_cast<unsigned int>(GL_COMMAND_BARRIER_BIT)
+        | static_cast<unsigned int>(GL_PIXEL_BUFFER_BARRIER_BIT)
+        | static_cast<unsigned int>(GL_TEXTURE_UPDATE_BARRIER_BIT)
+        | static_cast<unsigned int>(GL_BUFFER_UPDATE_BARRIER_BIT)
+        | static_cast<unsigned int>(GL_ATOMIC_COUNTER_BARRIER_BIT)
+        | static_cast<unsigned int>(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+
+} // namespace
+
+
+namespace globjects
+{
+
+
+BarrierTracker::BarrierTracker()
+: m_enabled(false)
+, m_required(0u)
+{
+}
+
+BarrierTracker::~BarrierTracker()
+{
+}
+
+BarrierTracker & BarrierTracker::current()
+{
+    return Registry::current().barrierTracker();
+}
+
+bool BarrierTracker::isEnabled() const
+{
+    return m_enabled;
+}
+
+void BarrierTracker::setEnabled(const bool enabled)
+{
+    m_enabled = enabled;
+
+    if (!enabled)
+    {
+        for (auto & bindings : m_bindings)
+        {
+            bindings.clear();
+        }
+
+        m_pending.clear();
+        m_required = 0u;
+    }
+}
+
+void BarrierTracker::bindBuffer(const GLenum target, const GLuint id)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    if (target == GL_DRAW_INDIRECT_BUFFER || target == GL_DISPATCH_INDIRECT_BUFFER || target == GL_PARAMETER_BUFFER)
+    {
+        bind(Slot::Indirect, static_cast<GLuint>(target), Type::Buffer, id, false);
+    }
+    else if (target == GL_PIXEL_PACK_BUFFER || target == GL_PIXEL_UNPACK_BUFFER)
+    {
+        bind(Slot::Pixel, static_cast<GLuint>(target), Type::Buffer, id, false);
+    }
+}
+
+void BarrierTracker::bindBuffer(const GLenum target, const GLuint index, const GLuint id)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    if (target == GL_SHADER_STORAGE_BUFFER)
+    {
+        bind(Slot::ShaderStorage, index, Type::Buffer, id, true);
+    }
+    else if (target == GL_ATOMIC_COUNTER_BUFFER)
+    {
+        bind(Slot::AtomicCounter, index, Type::Buffer, id, true);
+    }
+    else if (target == GL_UNIFORM_BUFFER)
+    {
+        bind(Slot::Uniform, index, Type::Buffer, id, false);
+    }
+}
+
+void BarrierTracker::bindTexture(const GLuint unit, const GLuint id)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    bind(Slot::Texture, unit, Type::Texture, id, false);
+}
+
+void BarrierTracker::bindTexture(const GLuint id)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    const GLuint unit = static_cast<GLuint>(getInteger(GL_ACTIVE_TEXTURE)) - static_cast<GLuint>(GL_TEXTURE0);
+
+    bind(Slot::Texture, unit, Type::Texture, id, false);
+}
+
+void BarrierTracker::bindImage(const GLuint unit, const GLuint id, const GLenum access)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    bind(Slot::Image, unit, Type::Texture, id, access != GL_READ_ONLY);
+}
+
+void BarrierTracker::read(const Type type, const GLuint id, const MemoryBarrierMask bits)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    require(key(type, id), static_cast<unsigned int>(bits));
+}
+
+void BarrierTracker::command()
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    if (!m_pending.empty())
+    {
+        for (unsigned int slot = 0; slot < static_cast<unsigned int>(Slot::Count); ++slot)
+        {
+            requireBindings(static_cast<Slot>(slot));
+        }
+    }
+
+    barrier();
+
+    // written by this command, as far as we can tell
+    for (const Slot slot : { Slot::ShaderStorage, Slot::AtomicCounter, Slot::Image })
+    {
+        for (const auto & pair : m_bindings[static_cast<std::size_t>(slot)])
+        {
+            if (pair.second.writable)
+            {
+                m_pending[pair.second.resource] = trackedBits();
+            }
+        }
+    }
+}
+
+void BarrierTracker::bufferUpdate(const GLuint id)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    require(key(Type::Buffer, id), static_cast<unsigned int>(GL_BUFFER_UPDATE_BARRIER_BIT));
+    barrier();
+}
+
+void BarrierTracker::textureUpdate(const GLuint id)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    require(key(Type::Texture, id), static_cast<unsigned int>(GL_TEXTURE_UPDATE_BARRIER_BIT));
+    requireBindings(Slot::Pixel);
+    barrier();
+}
+
+void BarrierTracker::pixelTransfer()
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    requireBindings(Slot::Pixel);
+    barrier();
+}
+
+void BarrierTracker::barrier()
+{
+    if (m_required == 0u)
+    {
+        return;
+    }
+
+    glMemoryBarrier(static_cast<MemoryBarrierMask>(m_required));
+
+    // barriers are global, so the issued bits are done for every resource
+    for (auto it = m_pending.begin(); it != m_pending.end();)
+    {
+        it->second &= ~m_required;
+
+        if (it->second == 0u)
+        {
+            it = m_pending.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    m_required = 0u;
+}
+
+std::uint64_t BarrierTracker::key(const Type type, const GLuint id)
+{
+    return (static_cast<std::uint64_t>(type) << 32) | static_cast<std::uint64_t>(id);
+}
+
+unsigned int BarrierTracker::slotBits(const Slot slot)
+{
+    switch (slot)
+    {
+    case Slot::ShaderStorage:
+        return static_cast<unsigned int>(GL_SHADER_STORAGE_BARRIER_BIT);
+    case Slot::AtomicCounter:
+        return static_cast<unsigned int>(GL_ATOMIC_COUNTER_BARRIER_BIT);
+    case Slot::Uniform:
+        return static_cast<unsigned int>(GL_UNIFORM_BARRIER_BIT);
+    case Slot::Image:
+        return static_cast<unsigned int>(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    case Slot::Texture:
+        return static_cast<unsigned int>(GL_TEXTURE_FETCH_BARRIER_BIT);
+    case Slot::Indirect:
+        return static_cast<unsigned int>(GL_COMMAND_BARRIER_BIT);
+    case Slot::Pixel:
+        return static_cast<unsigned int>(GL_PIXEL_BUFFER_BARRIER_BIT);
+    default:
+        return 0u;
+    }
+}
+
+void BarrierTracker::bind(const Slot slot, const GLuint index, const Type type, const GLuint id, const bool writable)
+{
+    Bindings & bindings = m_bindings[static_cast<std::size_t>(slot)];
+
+    if (id == 0)
+    {
+        bindings.erase(index);
+    }
+    else
+    {
+        bindings[index] = Binding{ key(type, id), writable };
+    }
+}
+
+void BarrierTracker::require(const std::uint64_t resource, const unsigned int bits)
+{
+    const auto it = m_pending.find(resource);
+
+    if (it != m_pending.end())
+    {
+        m_required |= it->second & bits;
+    }
+}
+
+void BarrierTracker::requireBindings(const Slot slot)
+{
+    const unsigned int bits = slotBits(slot);
+
+    for (const auto & pair : m_bindings[static_cast<std::size_t>(slot)])
+    {
+        require(pair.second.resource, bits);
+    }
+}
+
+
+} // namespace globjects
@@ -0,0 +1,130 @@
+
+#pragma once
+
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+#include <glbinding/gl/types.h>
+
+
+namespace globjects
+{
+
+
+/** \brief Inserts the memory barriers required after incoherent shader writes.
+
+    When enabled, the bindings of buffers and textures made through
+    globjects are recorded: shader storage and atomic counter buffers and
+    images bound with write access are considered written by every
+    following draw or dispatch. Later reads of such a resource issue a
+    single glMemoryBarrier with only the bits of the reading paths, i.e.,
+    vertex and element fetches, uniform blocks, texture fetches, image and
+    shader storage accesses, indirect commands, pixel transfers as well as
+    buffer and texture updates, reads, copies and mappings. As barriers
+    are global, issued bits are cleared for all written resources.
+
+    Bindings made without globjects, framebuffer attachments and bindless
+    handles are not tracked. Names are tracked per context; a name reused
+    after deletion may cause one superfluous barrier.
+*/
+class BarrierTracker
+{
+public:
+    enum class Type : unsigned int
+    {
+        Buffer
+    ,   Texture
+    };
+
+
+public:
+    BarrierTracker();
+    ~BarrierTracker();
+
+    static BarrierTracker & current();
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+
+    /** \brief Records glBindBuffer for indirect and pixel buffer targets; id 0 unbinds.
+    */
+    void bindBuffer(gl::GLenum target, gl::GLuint id);
+
+    /** \brief Records glBindBufferBase/Range for indexed targets; id 0 unbinds.
+    */
+    void bindBuffer(gl::GLenum target, gl::GLuint index, gl::GLuint id);
+
+    void bindTexture(gl::GLuint unit, gl::GLuint id);
+
+    /** \brief Records glBindTexture on the active texture unit; id 0 unbinds.
+    */
+    void bindTexture(gl::GLuint id);
+    void bindImage(gl::GLuint unit, gl::GLuint id, gl::GLenum access);
+
+    /** \brief Requires the barrier bits for a read of the resource by the next command or barrier().
+    */
+    void read(Type type, gl::GLuint id, gl::MemoryBarrierMask bits);
+
+    /** \brief Issues the barrier for a draw or dispatch, with vertex fetches added by read(), and marks its writes.
+    */
+    void command();
+
+    /** \brief Issues the barrier for a buffer update, read, copy or mapping.
+    */
+    void bufferUpdate(gl::GLuint id);
+
+    /** \brief Issues the barrier for a texture update, read or copy, including bound pixel buffers.
+    */
+    void textureUpdate(gl::GLuint id);
+
+    /** \brief Issues the barrier for a pixel transfer without a texture, e.g., glReadPixels, through bound pixel buffers.
+    */
+    void pixelTransfer();
+
+    /** \brief Issues a glMemoryBarrier for all required bits, if any.
+    */
+    void barrier();
+
+
+protected:
+    enum class Slot : unsigned int
+    {
+        ShaderStorage
+    ,   AtomicCounter
+    ,   Uniform
+    ,   Image
+    ,   Texture
+    ,   Indirect
+    ,   Pixel
+    ,   Count
+    };
+
+    struct Binding
+    {
+        std::uint64_t resource;
+        bool writable;
+    };
+
+    using Bindings = std::unordered_map<gl::GLuint, Binding>;
+
+
+protected:
+    static std::uint64_t key(Type type, gl::GLuint id);
+    static unsigned int slotBits(Slot slot);
+
+    void bind(Slot slot, gl::GLuint index, Type type, gl::GLuint id, bool writable);
+    void require(std::uint64_t resource, unsigned int bits);
+    void requireBindings(Slot slot);
+
+
+protected:
+    bool m_enabled;
+    std::array<Bindings, static_cast<std::size_t>(Slot::Count)> m_bindings;
+    std::unordered_map<std::uint64_t, unsigned int> m_pending; ///< barrier bits not yet issued since the last write
+    unsigned int m_required;
+};
+
+
+} // namespace globjects
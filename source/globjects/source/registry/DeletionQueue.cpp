@@ -0,0 +1,176 @@
+
+#include "DeletionQueue.h"
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Sync.h>
+
+#include "Registry.h"
+
+
+using namespace gl;
+
+
+namespace globjects
+{
+
+
+DeletionQueue::DeletionQueue()
+: m_enabled(false)
+{
+}
+
+DeletionQueue::~DeletionQueue()
+{
+}
+
+DeletionQueue & DeletionQueue::current()
+{
+    return Registry::current().deletionQueue();
+}
+
+bool DeletionQueue::isEnabled() const
+{
+    return m_enabled;
+}
+
+void DeletionQueue::setEnabled(const bool enabled)
+{
+    m_enabled = enabled;
+}
+
+bool DeletionQueue::enqueue(const Type type, const GLuint id)
+{
+    if (!m_enabled)
+    {
+        return false;
+    }
+
+    m_queued[static_cast<std::size_t>(type)].push_back(id);
+
+    return true;
+}
+
+std::size_t DeletionQueue::flush()
+{
+    return deleteNames(m_queued) + flushSignaled(false);
+}
+
+std::size_t DeletionQueue::flushFenced()
+{
+    const std::size_t deleted = flushSignaled(false);
+
+    if (count(m_queued) == 0)
+    {
+        return deleted;
+    }
+
+    Batch batch;
+    batch.fence = Sync::fence(GL_SYNC_GPU_COMMANDS_COMPLETE);
+    batch.names.swap(m_queued);
+
+    m_fenced.push_back(std::move(batch));
+
+    return deleted;
+}
+
+std::size_t DeletionQueue::flushAll()
+{
+    return deleteNames(m_queued) + flushSignaled(true);
+}
+
+std::size_t DeletionQueue::queuedCount() const
+{
+    std::size_t queued = count(m_queued);
+
+    for (const auto & batch : m_fenced)
+    {
+        queued += count(batch.names);
+    }
+
+    return queued;
+}
+
+std::size_t DeletionQueue::count(const Names & names)
+{
+    std::size_t result = 0;
+
+    for (const auto & ids : names)
+    {
+        result += ids.size();
+    }
+
+    return result;
+}
+
+std::size_t DeletionQueue::deleteNames(Names & names)
+{
+    const auto ids = [&names](const Type type) -> std::vector<GLuint> & {
+        return names[static_cast<std::size_t>(type)];
+    };
+    const auto size = [&ids](const Type type) {
+        return static_cast<GLsizei>(ids(type).size());
+    };
+
+    const std::size_t deleted = count(names);
+
+    if (deleted == 0)
+    {
+        return 0;
+    }
+
+    // all buffer, framebuffer and texture implementations share the legacy deletion
+    if (!ids(Type::Buffer).empty())
+        glDeleteBuffers(size(Type::Buffer), ids(Type::Buffer).data());
+    if (!ids(Type::Framebuffer).empty())
+        glDeleteFramebuffers(size(Type::Framebuffer), ids(Type::Framebuffer).data());
+    if (!ids(Type::ProgramPipeline).empty())
+        glDeleteProgramPipelines(size(Type::ProgramPipeline), ids(Type::ProgramPipeline).data());
+    if (!ids(Type::Query).empty())
+        glDeleteQueries(size(Type::Query), ids(Type::Query).data());
+    if (!ids(Type::Renderbuffer).empty())
+        glDeleteRenderbuffers(size(Type::Renderbuffer), ids(Type::Renderbuffer).data());
+    if (!ids(Type::Sampler).empty())
+        glDeleteSamplers(size(Type::Sampler), ids(Type::Sampler).data());
+    if (!ids(Type::Texture).empty())
+        glDeleteTextures(size(Type::Texture), ids(Type::Texture).data());
+    if (!ids(Type::TransformFeedback).empty())
+        glDeleteTransformFeedbacks(size(Type::TransformFeedback), ids(Type::TransformFeedback).data());
+    if (!ids(Type::VertexArray).empty())
+        glDeleteVertexArrays(size(Type::VertexArray), ids(Type::VertexArray).data());
+
+    // programs and shaders have no batched deletion
+    for (const auto id : ids(Type::Program))
+        glDeleteProgram(id);
+    for (const auto id : ids(Type::Shader))
+        glDeleteShader(id);
+
+    for (auto & list : names)
+    {
+        list.clear();
+    }
+
+    return deleted;
+}
+
+std::size_t DeletionQueue::flushSignaled(const bool all)
+{
+    std::size_t deleted = 0;
+
+    auto it = m_fenced.begin();
+
+    // batches are fenced in order, so the first unsignaled fence ends the search
+    while (it != m_fenced.end() && (all || it->fence->isSignaled()))
+    {
+        deleted += deleteNames(it->names);
+        ++it;
+    }
+
+    m_fenced.erase(m_fenced.begin(), it);
+
+    return deleted;
+}
+
+
+} // namespace globjects
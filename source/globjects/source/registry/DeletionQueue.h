@@ -0,0 +1,101 @@
+
+#pragma once
+
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+
+namespace globjects
+{
+
+
+class Sync;
+
+
+/** \brief Collects GL names of destroyed objects to delete them in batches.
+
+    When enabled, resource destructors enqueue their names instead of
+    deleting them one by one. flush() deletes all queued names grouped by
+    type, using a single glDelete* call per type. flushFenced() defers the
+    deletion until the GPU passed a fence inserted at the time of the call.
+*/
+class DeletionQueue
+{
+public:
+    enum class Type : unsigned int
+    {
+        Buffer
+    ,   Framebuffer
+    ,   Program
+    ,   ProgramPipeline
+    ,   Query
+    ,   Renderbuffer
+    ,   Sampler
+    ,   Shader
+    ,   Texture
+    ,   TransformFeedback
+    ,   VertexArray
+    ,   Count
+    };
+
+
+public:
+    DeletionQueue();
+    ~DeletionQueue();
+
+    static DeletionQueue & current();
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+
+    /** \brief Queues id for deletion if the queue is enabled.
+        \return true if id was queued, false if the caller has to delete it
+    */
+    bool enqueue(Type type, gl::GLuint id);
+
+    /** \brief Deletes all queued names and fenced batches whose fence has been signaled.
+        \return number of deleted names
+    */
+    std::size_t flush();
+
+    /** \brief Queued names are deleted by a later flush once the GPU passed a fence inserted now.
+        \return number of deleted names of previously fenced batches
+    */
+    std::size_t flushFenced();
+
+    /** \brief Deletes all queued names, regardless of any fences.
+    */
+    std::size_t flushAll();
+
+    std::size_t queuedCount() const;
+
+
+protected:
+    using Names = std::array<std::vector<gl::GLuint>, static_cast<std::size_t>(Type::Count)>;
+
+    struct Batch
+    {
+        std::unique_ptr<Sync> fence;
+        Names names;
+    };
+
+
+protected:
+    static std::size_t count(const Names & names);
+    static std::size_t deleteNames(Names & names);
+
+    std::size_t flushSignaled(bool all);
+
+
+protected:
+    bool m_enabled;
+    Names m_queued;
+    std::vector<Batch> m_fenced;
+};
+
+
+} // namespace globjects
@@ -0,0 +1,163 @@
+
+#include "NamePool.h"
+
+#include <algorithm>
+
+#include <glbinding/gl/functions.h>
+
+#include "Registry.h"
+#include "ImplementationRegistry.h"
+
+#include "../implementations/AbstractBufferImplementation.h"
+#include "../implementations/AbstractTextureImplementation.h"
+
+
+using namespace gl;
+
+
+namespace globjects
+{
+
+
+NamePool::NamePool()
+: m_batchSize(s_defaultBatchSize)
+, m_bufferImplementation(nullptr)
+, m_textureImplementation(nullptr)
+{
+}
+
+NamePool::~NamePool()
+{
+}
+
+NamePool & NamePool::current()
+{
+    return Registry::current().namePool();
+}
+
+GLsizei NamePool::batchSize() const
+{
+    return m_batchSize;
+}
+
+void NamePool::setBatchSize(const GLsizei batchSize)
+{
+    const GLsizei previous = m_batchSize;
+
+    m_batchSize = std::max<GLsizei>(batchSize, 1);
+
+    // a pool never holds more than one batch minus the name just handed out
+    if (m_batchSize < previous)
+    {
+        trim(static_cast<std::size_t>(m_batchSize - 1));
+    }
+}
+
+GLuint NamePool::buffer()
+{
+    AbstractBufferImplementation & implementation = ImplementationRegistry::current().bufferImplementation();
+
+    if (m_bufferImplementation != &implementation)
+    {
+        if (!m_buffers.empty())
+        {
+            glDeleteBuffers(static_cast<GLsizei>(m_buffers.size()), m_buffers.data());
+            m_buffers.clear();
+        }
+
+        m_bufferImplementation = &implementation;
+    }
+
+    if (m_buffers.empty())
+    {
+        if (m_batchSize == 1)
+        {
+            return implementation.create();
+        }
+
+        m_buffers.resize(static_cast<std::size_t>(m_batchSize));
+        implementation.create(m_batchSize, m_buffers.data());
+
+        // hand out names in generation order
+        std::reverse(m_buffers.begin(), m_buffers.end());
+    }
+
+    const GLuint id = m_buffers.back();
+    m_buffers.pop_back();
+
+    return id;
+}
+
+GLuint NamePool::texture(const GLenum target)
+{
+    AbstractTextureImplementation & implementation = ImplementationRegistry::current().textureBindlessImplementation();
+
+    if (m_textureImplementation != &implementation)
+    {
+        for (auto & pair : m_textures)
+        {
+            if (!pair.second.empty())
+            {
+                glDeleteTextures(static_cast<GLsizei>(pair.second.size()), pair.second.data());
+            }
+        }
+
+        m_textures.clear();
+        m_textureImplementation = &implementation;
+    }
+
+    auto & textures = m_textures[target];
+
+    if (textures.empty())
+    {
+        if (m_batchSize == 1)
+        {
+            return implementation.create(target);
+        }
+
+        textures.resize(static_cast<std::size_t>(m_batchSize));
+        implementation.create(target, m_batchSize, textures.data());
+
+        std::reverse(textures.begin(), textures.end());
+    }
+
+    const GLuint id = textures.back();
+    textures.pop_back();
+
+    return id;
+}
+
+void NamePool::clear()
+{
+    trim(0);
+
+    m_textures.clear();
+}
+
+void NamePool::trim(const std::size_t count)
+{
+    // names are handed out from the back, so the excess is at the front
+    if (m_buffers.size() > count)
+    {
+        const auto excess = m_buffers.size() - count;
+
+        glDeleteBuffers(static_cast<GLsizei>(excess), m_buffers.data());
+        m_buffers.erase(m_buffers.begin(), m_buffers.begin() + static_cast<std::ptrdiff_t>(excess));
+    }
+
+    for (auto & pair : m_textures)
+    {
+        auto & textures = pair.second;
+
+        if (textures.size() > count)
+        {
+            const auto excess = textures.size() - count;
+
+            glDeleteTextures(static_cast<GLsizei>(excess), textures.data());
+            textures.erase(textures.begin(), textures.begin() + static_cast<std::ptrdiff_t>(excess));
+        }
+    }
+}
+
+
+} // namespace globjects
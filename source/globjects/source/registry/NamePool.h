@@ -0,0 +1,72 @@
+
+#pragma once
+
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include <glbinding/gl/types.h>
+
+
+namespace globjects
+{
+
+
+class AbstractBufferImplementation;
+class AbstractTextureImplementation;
+
+
+/** \brief Hands out buffer and texture names that are generated in batches.
+
+    Instead of one glGen*() or glCreate*() call per object, names are generated
+    batchSize() at a time by the current buffer and texture implementation.
+    Textures are pooled per target, as glCreateTextures fixes the target.
+    When the implementation changes, unused names are discarded, since names
+    generated by glGen* are not valid for direct state access before their
+    first binding.
+
+    Pooling is off (a batch size of 1) unless enabled by setBatchSize(), as
+    glCreate*() makes each pooled name a real object of the context.
+*/
+class NamePool
+{
+public:
+    static const gl::GLsizei s_defaultBatchSize = 1;
+
+
+public:
+    NamePool();
+    ~NamePool();
+
+    static NamePool & current();
+
+    gl::GLsizei batchSize() const;
+    void setBatchSize(gl::GLsizei batchSize);
+
+    gl::GLuint buffer();
+    gl::GLuint texture(gl::GLenum target);
+
+    /** \brief Deletes all unused names.
+    */
+    void clear();
+
+
+protected:
+    /** \brief Deletes unused names beyond the given count per pool.
+    */
+    void trim(std::size_t count);
+
+
+protected:
+    gl::GLsizei m_batchSize;
+
+    const AbstractBufferImplementation * m_bufferImplementation;
+    std::vector<gl::GLuint> m_buffers;
+
+    const AbstractTextureImplementation * m_textureImplementation;
+    std::unordered_map<gl::GLenum, std::vector<gl::GLuint>> m_textures;
+};
+
+
+} // namespace globjects
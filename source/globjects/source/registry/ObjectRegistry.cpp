@@ -23,19 +23,50 @@ ObjectRegistry & ObjectRegistry::current()
     return Registry::current().objects();
 }
 
-std::set<Object*> ObjectRegistry::objects() const
+void ObjectRegistry::forEach(const std::function<void(Object *)> & visitor) const
 {
-    return m_objects;
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (Object * object : m_objects)
+    {
+        visitor(object);
+    }
 }
 
-std::set<Object *>::iterator ObjectRegistry::begin()
+void ObjectRegistry::detachAll()
 {
-    return m_objects.begin();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (Object * object : m_objects)
+    {
+        // deregistered here at once; detach() skips deregistration, which would lock again
+        object->m_registryIndex = s_invalidIndex;
+        object->detach();
+    }
+
+    m_objects.clear();
 }
 
-std::set<Object *>::iterator ObjectRegistry::end()
+std::size_t ObjectRegistry::size() const
 {
-    return m_objects.end();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_objects.size();
+}
+
+std::unordered_map<gl::GLenum, std::size_t> ObjectRegistry::countsByType() const
+{
+    std::unordered_map<gl::GLenum, std::size_t> counts;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // the type is not known yet when the Object base class registers itself
+    for (const Object * object : m_objects)
+    {
+        ++counts[object->objectType()];
+    }
+
+    return counts;
 }
 
 void ObjectRegistry::registerObject(Object * object)
@@ -45,17 +76,30 @@ void ObjectRegistry::registerObject(Object * object)
     if (object->id() == 0)
         return;
 
-    m_objects.insert(object);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    object->m_registryIndex = m_objects.size();
+    m_objects.push_back(object);
 }
 
 void ObjectRegistry::deregisterObject(Object * object)
 {
     assert(object != nullptr);
 
-    if (object->id() == 0)
+    if (object->m_registryIndex == s_invalidIndex)
         return;
 
-    m_objects.erase(object);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const std::size_t index = object->m_registryIndex;
+    assert(index < m_objects.size() && m_objects[index] == object);
+
+    Object * last = m_objects.back();
+    m_objects[index] = last;
+    last->m_registryIndex = index;
+
+    m_objects.pop_back();
+    object->m_registryIndex = s_invalidIndex;
 }
 
 
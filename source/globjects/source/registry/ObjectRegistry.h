@@ -2,7 +2,13 @@
 #pragma once
 
 
-#include <set>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <glbinding/gl/types.h>
 
 
 namespace globjects 
@@ -16,21 +22,41 @@ class VertexArray;
 
 /** \brief Tracks all wrapped OpenGL objects in globjects.
     
-    To obtain all wrapped objects use objects().
+    To visit all wrapped objects use forEach().
+    Objects are kept in a dense array and remember their position, so
+    registration and deregistration take constant time (deregistration
+    moves the last object into the freed slot, thus the order is not stable).
+    The registry is shared among shared contexts, which may live on other
+    threads (e.g., an UploadWorker), so all accesses are synchronized;
+    forEach() holds the lock while visiting, without copying the objects.
 */
 class ObjectRegistry
 {
     friend class Object;
 
 
+public:
+    static const std::size_t s_invalidIndex = static_cast<std::size_t>(-1);
+
+
 public:
     ObjectRegistry();
     static ObjectRegistry & current();
 
-    std::set<Object *> objects() const;
+    /** \brief Calls visitor for each registered object while holding the registry's lock.
+        The visitor must not create or destroy objects, which would deadlock.
+    */
+    void forEach(const std::function<void(Object *)> & visitor) const;
+
+    /** \brief Detaches all registered objects from their OpenGL names at once, see Object::detach().
+    */
+    void detachAll();
+
+    std::size_t size() const;
 
-    std::set<Object *>::iterator begin();
-    std::set<Object *>::iterator end();
+    /** \brief Counts the registered objects per object type (linear in the number of objects).
+    */
+    std::unordered_map<gl::GLenum, std::size_t> countsByType() const;
 
 
 protected:
@@ -39,7 +65,8 @@ protected:
 
 
 protected:
-    std::set<Object *> m_objects;
+    std::vector<Object *> m_objects;
+    mutable std::mutex m_mutex;
 };
 
 
@@ -1,25 +1,94 @@
 
 #include "Registry.h"
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include <globjects/globjects_features.h>
 #include <globjects/logging.h>
+#include <globjects/AsyncPoller.h>
 
 #include "ObjectRegistry.h"
 #include "ExtensionRegistry.h"
 #include "ImplementationRegistry.h"
 #include "NamedStringRegistry.h"
+#include "DeletionQueue.h"
+#include "NamePool.h"
+#include "BarrierTracker.h"
 
 
 namespace
 {
 
 
+using RegistryMap = std::unordered_map<glbinding::ContextHandle, globjects::Registry *>;
+
 GLOBJECTS_THREAD_LOCAL globjects::Registry * t_currentRegistry;
+
+// Copy-on-write snapshot of all registries: lookups load the current snapshot
+// without locking, (de)registration copies it under g_mutex and publishes the copy.
+// Replaced snapshots may still be read by other threads; they are retired and
+// deleted by a later publish that observes no reader.
+std::atomic<const RegistryMap *> g_registries(nullptr);
+std::unique_ptr<const RegistryMap> g_snapshot;
+std::vector<std::unique_ptr<const RegistryMap>> g_retired;
 std::recursive_mutex g_mutex;
 
 
+// Readers are counted in per-thread slots, each on its own cache line, so
+// concurrent lookups do not write shared memory. Threads are assigned slots
+// round-robin; beyond s_readerSlotCount threads, slots are shared.
+const std::size_t s_readerSlotCount = 64;
+
+struct alignas(64) ReaderSlot
+{
+    std::atomic<unsigned int> readers;
+};
+
+std::array<ReaderSlot, s_readerSlotCount> g_readerSlots;
+std::atomic<std::size_t> g_nextReaderSlot(0u);
+
+GLOBJECTS_THREAD_LOCAL ReaderSlot * t_readerSlot;
+
+
+// Announces a lookup before the snapshot is loaded, see Registry::publish.
+class SnapshotReader
+{
+public:
+    SnapshotReader()
+    {
+        if (t_readerSlot == nullptr)
+        {
+            t_readerSlot = &g_readerSlots[g_nextReaderSlot.fetch_add(1u, std::memory_order_relaxed) % s_readerSlotCount];
+        }
+
+        t_readerSlot->readers.fetch_add(1u);
+    }
+
+    ~SnapshotReader()
+    {
+        t_readerSlot->readers.fetch_sub(1u);
+    }
+};
+
+
+bool hasReaders()
+{
+    for (const auto & slot : g_readerSlots)
+    {
+        if (slot.readers.load() != 0u)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
 } // namespace
 
 
@@ -27,8 +96,6 @@ namespace globjects
 {
 
 
-std::unordered_map<glbinding::ContextHandle, Registry *> Registry::s_registries;
-
 void Registry::registerContext(glbinding::ContextHandle contextId)
 {
     if (isContextRegistered(contextId))
@@ -48,12 +115,12 @@ void Registry::registerContext(const glbinding::ContextHandle contextId, const g
 
     std::lock_guard<std::recursive_mutex> lock(g_mutex);
 
-    auto it = s_registries.find(sharedContextId);
-    assert(it != s_registries.end());
+    Registry * sharedRegistry = find(sharedContextId);
+    assert(sharedRegistry != nullptr);
 
-    Registry * registry = new Registry(it->second);
+    Registry * registry = new Registry(sharedRegistry);
 
-    s_registries[contextId] = registry;
+    publish(contextId, registry);
 
     t_currentRegistry = registry;
     //registry->initialize();
@@ -61,21 +128,21 @@ void Registry::registerContext(const glbinding::ContextHandle contextId, const g
 
 void Registry::setCurrentContext(const glbinding::ContextHandle contextId)
 {
-    if (!isContextRegistered(contextId))
+    if (Registry * registry = find(contextId))
     {
-        globjects::debug() << "Requesting OpenGL context " << contextId << " but it isn't registered yet";
+        t_currentRegistry = registry;
+
+        return;
     }
 
+    globjects::debug() << "Requesting OpenGL context " << contextId << " but it isn't registered yet";
+
     setCurrentRegistry(contextId);
 }
 
 bool Registry::isCurrentContext(glbinding::ContextHandle contextId)
 {
-    std::lock_guard<std::recursive_mutex> lock(g_mutex);
-
-    const auto it = s_registries.find(contextId);
-
-    return it != s_registries.end() && it->second == t_currentRegistry;
+    return t_currentRegistry != nullptr && find(contextId) == t_currentRegistry;
 }
 
 void Registry::deregisterContext(const glbinding::ContextHandle contextId)
@@ -90,9 +157,18 @@ void Registry::deregisterContext(const glbinding::ContextHandle contextId)
     {
         std::lock_guard<std::recursive_mutex> lock(g_mutex);
 
-        delete s_registries[contextId];
+        Registry * registry = find(contextId);
+
+        // names can only be deleted while the context is current
+        if (registry != nullptr && registry == t_currentRegistry)
+        {
+            t_currentRegistry->deletionQueue().flushAll();
+            t_currentRegistry->namePool().clear();
+        }
 
-        s_registries[contextId] = nullptr;
+        publish(contextId, nullptr);
+
+        delete registry;
     }
 
     t_currentRegistry = nullptr;
@@ -107,31 +183,85 @@ Registry & Registry::current()
 
 bool Registry::isContextRegistered(const glbinding::ContextHandle contextId)
 {
+    const SnapshotReader reader;
+    const RegistryMap * registries = g_registries.load();
+
+    return registries != nullptr && registries->find(contextId) != registries->end();
+}
+
+void Registry::setCurrentRegistry(const glbinding::ContextHandle contextId)
+{
+    // a single lookup each, as the context may be deregistered in between two
+    if (Registry * registry = find(contextId))
+    {
+        t_currentRegistry = registry;
+
+        return;
+    }
+
     std::lock_guard<std::recursive_mutex> lock(g_mutex);
 
-    bool found = s_registries.find(contextId) != s_registries.end();
+    // another thread may have registered the context meanwhile
+    if (Registry * registry = find(contextId))
+    {
+        t_currentRegistry = registry;
+
+        return;
+    }
+
+    Registry * registry = new Registry();
 
-    return found;
+    t_currentRegistry = registry;
+    registry->initialize();
+
+    // publish only fully initialized registries, as lookups do not lock
+    publish(contextId, registry);
 }
 
-void Registry::setCurrentRegistry(const glbinding::ContextHandle contextId)
+Registry * Registry::find(const glbinding::ContextHandle contextId)
+{
+    const SnapshotReader reader;
+    const RegistryMap * registries = g_registries.load();
+
+    if (registries == nullptr)
+    {
+        return nullptr;
+    }
+
+    const auto it = registries->find(contextId);
+
+    return it == registries->end() ? nullptr : it->second;
+}
+
+void Registry::publish(const glbinding::ContextHandle contextId, Registry * registry)
 {
     std::lock_guard<std::recursive_mutex> lock(g_mutex);
 
-    const auto it = s_registries.find(contextId);
+    std::unique_ptr<RegistryMap> registries(g_snapshot != nullptr ? new RegistryMap(*g_snapshot) : new RegistryMap);
 
-    if (it != s_registries.end())
+    if (registry != nullptr)
     {
-        t_currentRegistry = it->second;
+        (*registries)[contextId] = registry;
     }
     else
     {
-        Registry * registry = new Registry();
+        registries->erase(contextId);
+    }
 
-        s_registries[contextId] = registry;
+    g_registries.store(registries.get());
 
-        t_currentRegistry = registry;
-        registry->initialize();
+    if (g_snapshot != nullptr)
+    {
+        g_retired.push_back(std::move(g_snapshot));
+    }
+
+    g_snapshot = std::move(registries);
+
+    // A reader of a retired snapshot loaded it before the store above, and announced
+    // itself in its slot before that load; with no reader announced now, none of them is in use.
+    if (!hasReaders())
+    {
+        g_retired.clear();
     }
 }
 
@@ -146,6 +276,10 @@ Registry::Registry(Registry * sharedRegistry)
 , m_extensions(sharedRegistry->m_extensions)
 , m_implementations(sharedRegistry->m_implementations)
 , m_namedStrings(sharedRegistry->m_namedStrings)
+, m_asyncPoller(new AsyncPoller)
+, m_deletionQueue(new DeletionQueue)
+, m_namePool(new NamePool)
+, m_barrierTracker(new BarrierTracker)
 {
 }
 
@@ -159,6 +293,10 @@ void Registry::initialize()
     m_extensions.reset(new ExtensionRegistry);
     m_namedStrings.reset(new NamedStringRegistry);
     m_implementations.reset(new ImplementationRegistry);
+    m_asyncPoller.reset(new AsyncPoller);
+    m_deletionQueue.reset(new DeletionQueue);
+    m_namePool.reset(new NamePool);
+    m_barrierTracker.reset(new BarrierTracker);
 
     m_initialized = true;
 }
@@ -188,5 +326,25 @@ NamedStringRegistry & Registry::namedStrings()
     return *m_namedStrings;
 }
 
+AsyncPoller & Registry::asyncPoller()
+{
+    return *m_asyncPoller;
+}
+
+DeletionQueue & Registry::deletionQueue()
+{
+    return *m_deletionQueue;
+}
+
+NamePool & Registry::namePool()
+{
+    return *m_namePool;
+}
+
+BarrierTracker & Registry::barrierTracker()
+{
+    return *m_barrierTracker;
+}
+
 
 } // namespace globjects
@@ -16,6 +16,10 @@ class ObjectRegistry;
 class ExtensionRegistry;
 class ImplementationRegistry;
 class NamedStringRegistry;
+class AsyncPoller;
+class DeletionQueue;
+class NamePool;
+class BarrierTracker;
 
 
 class Registry
@@ -35,6 +39,10 @@ public:
     ExtensionRegistry & extensions();
     ImplementationRegistry & implementations();
     NamedStringRegistry & namedStrings();
+    AsyncPoller & asyncPoller();
+    DeletionQueue & deletionQueue();
+    NamePool & namePool();
+    BarrierTracker & barrierTracker();
 
     bool isInitialized() const;
 
@@ -49,7 +57,8 @@ private:
     static bool isContextRegistered(glbinding::ContextHandle contextId);
     static void setCurrentRegistry(glbinding::ContextHandle contextId);
 
-    static std::unordered_map<glbinding::ContextHandle, Registry *> s_registries;
+    static Registry * find(glbinding::ContextHandle contextId);
+    static void publish(glbinding::ContextHandle contextId, Registry * registry);
 
 
 private:
@@ -58,6 +67,10 @@ private:
     std::shared_ptr<ExtensionRegistry> m_extensions;
     std::shared_ptr<ImplementationRegistry> m_implementations;
     std::shared_ptr<NamedStringRegistry> m_namedStrings;
+    std::shared_ptr<AsyncPoller> m_asyncPoller; // per context, as query objects are not shared
+    std::shared_ptr<DeletionQueue> m_deletionQueue; // per context, as container objects are not shared
+    std::shared_ptr<NamePool> m_namePool; // per context, to avoid locking on object creation
+    std::shared_ptr<BarrierTracker> m_barrierTracker; // per context, as bindings are not shared
 };
 
 